@@ -68,13 +68,36 @@
 #define TICKS_POR_RODAJA 10
 
 /* constantes usada en implementacion de mutex */
-#define NUM_MUT 16 /* numero total de mutex en el sistema */
-#define NUM_MUT_PROC 4 /* numero maximo de mutex que puede tener
-			  abiertos un proceso */
+#define NUM_MUT 16 /* mutex por bloque de la tabla de mutex, que empieza
+		      con un bloque y crece bajo demanda */
+#define MAX_MUT 64 /* limite de mutex en el sistema (multiplo de NUM_MUT).
+		      Al alcanzarlo crear_mutex se bloquea o falla */
+#define NUM_DESC_PROC 32 /* numero maximo de descriptores que puede tener
+			  abiertos un proceso (como mucho 32, ya que los
+			  libres se llevan en un mapa de bits de un int) */
 #define MAX_NOM_MUT 8 /* longitud maxima de un nombre de mutex */
 
 /* constante usada en implementacion de manejador de terminal */
-#define TAM_BUF_TERM 8 /* tamao del buffer del terminal */
+#define TAM_BUF_TERM 64 /* tamao del buffer del terminal */
+
+/* tamao del buffer de salida de cada proceso en la biblioteca */
+#define TAM_BUF_SALIDA 1024
+
+/* tamao de la cola de salida por consola del kernel */
+#define TAM_COLA_CONSOLA 4096
+
+/* sucesos que guarda la traza binaria del kernel */
+#define TAM_TRAZA 4096
+
+/* tamao del buffer circular de cada tubera */
+#define TAM_TUBERIA 512
+
+/* tamao mximo de un segmento de memoria compartida */
+#define MAX_TAM_MEMORIA (1024 * 1024)
+
+/* constantes usadas en implementacion de buzones */
+#define TAM_MENSAJE 64 /* tamao fijo de cada mensaje */
+#define MAX_MENSAJES_BUZON 32 /* profundidad mxima de un buzn */
 
 /* direccin de puerto de E/S del terminal */
 #define DIR_TERMINAL 1
@@ -22,11 +22,60 @@
 #include "HAL.h"
 #include "llamsis.h"
 #include "string.h"
+#include <stdlib.h>
+#include <time.h>
 
 /* Definicion tipos mutex*/
 #define RECURSIVO 0
 #define NO_RECURSIVO 1
 
+/* Opcion que se puede sumar al tipo: al desbloquear el mutex se cede
+   directamente al primer proceso que espera por el */
+#define MUTEX_TRASPASO 2
+
+/* Opcion que se puede sumar al tipo: si se ha alcanzado MAX_MUT crear_mutex
+   devuelve un error en vez de bloquearse */
+#define MUTEX_SIN_ESPERA 4
+
+/* Modos de entrada del terminal */
+#define TERM_CARACTER 0 /* cada caracter se puede leer nada mas llegar */
+#define TERM_LINEA 1 /* se entregan lineas completas, con borrado en el kernel */
+
+/*
+ * Prioridades de los procesos: a mayor valor, mas prioridad
+ */
+#define PRIORIDAD_DEFECTO 0
+#define MAX_PRIORIDAD 31
+
+/*
+ * Plazo de las esperas que no vencen nunca
+ */
+#define ESPERA_INDEFINIDA -1
+
+/*
+ * Definicion de la tabla de descriptores de cada proceso. Un descriptor es
+ * el indice de una entrada que apunta directamente al objeto del kernel.
+ */
+#define DESC_MUTEX 1 /* el descriptor se refiere a un mutex */
+#define DESC_RWLOCK 2 /* el descriptor se refiere a un cerrojo de lectores/escritores */
+#define DESC_SEMAFORO 3 /* el descriptor se refiere a un semaforo */
+#define DESC_CONDICION 4 /* el descriptor se refiere a una variable condicion */
+#define DESC_BARRERA 5 /* el descriptor se refiere a una barrera */
+#define DESC_CONTADOR 6 /* el descriptor se refiere a un contador */
+#define DESC_TUB_LECTURA 7 /* el descriptor es el extremo de lectura de una tuberia */
+#define DESC_TUB_ESCRITURA 8 /* el descriptor es el extremo de escritura de una tuberia */
+#define DESC_MEMORIA 9 /* el descriptor se refiere a un segmento de memoria compartida */
+#define DESC_BUZON 10 /* el descriptor se refiere a un buzon */
+
+/* mapa de bits con todos los descriptores libres */
+#define DESCS_TODOS_LIBRES ((unsigned int)((1ULL << NUM_DESC_PROC) - 1))
+
+typedef struct {
+	int tipo; // tipo del objeto al que se refiere
+	int obj; // posicion del objeto en su tabla del sistema
+	int cogido; // cerrojos: RW_LECTURA o RW_ESCRITURA si lo tiene cogido, 0 si no
+} descriptor;
+
 /*
  *
  * Definicion del tipo que corresponde con el BCP.
@@ -46,8 +95,22 @@ typedef struct BCP_t
 	int ticks_bloq;		  	  /* ticks que le quedan para desbloquearse en el caso de que lo este*/
 	int int_usuario;		  /* veces que ha habido interrupcion de reloj en modo usuario*/
 	int int_sistema;          /* veces que ha habido interrupcion de reloj en modo sistema*/
-	int desc_mutex[NUM_MUT_PROC]; /* lista con los descriptores de mutex del proceso, -1 por defecto en cada posicion */
+	descriptor descs[NUM_DESC_PROC]; /* tabla de descriptores del proceso */
+	unsigned int descs_libres; /* mapa de bits de descriptores libres (bit a 1 = libre) */
 	int ticks_rodaja_restantes; /*ticks restantes que tiene para completar su rodaja*/ 
+	int prioridad_base; /* prioridad fijada por el propio proceso */
+	int prioridad; /* prioridad efectiva, incluye la heredada por mutex */
+	struct mutex_t *mutex_esperado; /* mutex por el que esta bloqueado, NULL si no */
+	struct lista_BCPs_t *lista_espera; /* lista en la que esta bloqueado */
+	int ticks_plazo; /* ticks que le quedan a su espera con plazo, 0 si no tiene */
+	int plazo_vencido; /* si le ha despertado el vencimiento del plazo */
+	unsigned long inicio_espera; /* tick en que empezo a esperar por un mutex o un buzon */
+	int objetivo_contador; /* valor que espera que alcance un contador */
+	int eventos_terminal; /* en esperar_eventos, si espera caracteres del terminal */
+	struct mutex_t **eventos_mutex; /* en esperar_eventos, mutex que espera que queden libres */
+	int n_eventos_mutex; /* numero de elementos de eventos_mutex */
+	char *buf_mensaje; /* donde recibe el mensaje mientras espera en un buzon */
+	int mensaje_recibido; /* si un emisor le ha dejado el mensaje en buf_mensaje */
 } BCP;
 
 /*
@@ -58,7 +121,7 @@ typedef struct BCP_t
  *
  */
 
-typedef struct
+typedef struct lista_BCPs_t
 {
 	BCP *primero;
 	BCP *ultimo;
@@ -96,6 +159,17 @@ lista_BCPs lista_bloq_mutex = {NULL, NULL};
  */
 lista_BCPs lista_bloq_lectura = {NULL, NULL};
 
+/*
+ * Variable global que representa la cola de procesos bloqueados esperando
+ * sitio en la cola de salida por consola
+ */
+lista_BCPs lista_bloq_escritura = {NULL, NULL};
+
+/*
+ * Variable global que representa la cola de procesos bloqueados en esperar_eventos
+ */
+lista_BCPs lista_bloq_eventos = {NULL, NULL};
+
 
 /*
  * Variable global que guarda el numero de interrupciones de reloj totales
@@ -113,7 +187,65 @@ int acceso_parametro = 0;
 * Variable global que registra el id del proceso que se pretende expulsar con int. sw.
 */
 
-int proc_a_expulsar;
+int proc_a_expulsar = -1;
+
+/*
+ * Instrumentacion de las secciones con interrupciones inhabilitadas.
+ * Todas las llamadas a fijar_nivel_int del kernel pasan por
+ * fijar_nivel_int_instr, que registra por punto de llamada cuantas veces
+ * se eleva el nivel a NIVEL_3 y cuanto tiempo (ns) se mantiene asi.
+ * No incluye el tiempo que el HAL eleva el nivel al tratar una interrupcion.
+ */
+#define MAX_SITIOS_INT 32 /* numero maximo de puntos de llamada distintos */
+
+typedef struct {
+	const char *funcion; // funcion desde la que se eleva el nivel
+	int linea; // linea de la llamada
+	unsigned long veces; // secciones abiertas desde este punto
+	unsigned long long total_ns; // tiempo total con interrupciones inhabilitadas
+	unsigned long long max_ns; // seccion mas larga
+} estad_int;
+
+estad_int tabla_estad_int[MAX_SITIOS_INT];
+
+int n_sitios_int = 0; // entradas usadas de tabla_estad_int
+
+int sitio_int_actual = -1; // sitio que abrio la seccion en curso, -1 si no hay
+
+unsigned long long inicio_seccion_int; // instante en que se abrio la seccion en curso
+
+int fijar_nivel_int_instr(int nivel, const char *funcion, int linea);
+
+#define fijar_nivel_int(nivel) fijar_nivel_int_instr(nivel, __func__, __LINE__)
+
+/*
+ * Traza binaria de sucesos del kernel: buffer circular con los ultimos
+ * TAM_TRAZA sucesos, con el instante en ns del reloj del host y el proceso
+ * al que se refieren. Se lee con la llamada leer_traza
+ */
+#define TRAZA_CAMBIO 1 /* cambio de contexto de proc a dato */
+#define TRAZA_BLOQUEO 2 /* proc se bloquea */
+#define TRAZA_DESPERTAR 3 /* proc vuelve a estar listo */
+#define TRAZA_LLAMADA 4 /* proc entra en la llamada dato */
+#define TRAZA_FIN_LLAMADA 5 /* proc sale de la llamada dato */
+#define TRAZA_INT_RELOJ 6 /* interrupciones, con proc el proceso actual */
+#define TRAZA_INT_TERMINAL 7
+#define TRAZA_INT_SW 8
+#define TRAZA_COGER_MUTEX 9 /* proc coge en el kernel el mutex de id dato */
+#define TRAZA_SOLTAR_MUTEX 10 /* proc suelta en el kernel el mutex de id dato */
+
+typedef struct suceso_traza_t {
+	unsigned long long instante; // ns del reloj del host
+	int tipo; // TRAZA_CAMBIO...
+	int proc; // proceso al que se refiere, -1 si ninguno
+	int dato; // segun el tipo
+} suceso_traza;
+
+suceso_traza traza[TAM_TRAZA];
+
+unsigned long n_sucesos = 0; // sucesos anotados desde el arranque
+
+void anotar_traza(int tipo, int proc, int dato);
 
 /*
  *
@@ -139,32 +271,335 @@ typedef struct tiempos_ejec_t {
  * Definicion sistema de MUTEX 
  */
 
-#define LOCKED 0
 #define SIN_USAR 1
-#define UNLOCKED 2
+#define EN_USO 2
 
 typedef struct mutex_t {
-	char nombre[MAX_NOM_MUT]; //nombre 
-	int tipo;	//Recursivo o no recursivo
-	int estado; // estado libre o bloqueado
+	char nombre[MAX_NOM_MUT + 1]; // nombre
+	int estado; // entrada sin usar o en uso
 	int id; // id del mutex
-	int owner; // proceso que tiene el mutex
-	int n_blocks; // nº de veces que un proceso ha bloqueado dicho mutex
 	int n_opens; // contador de procesos que tienen abierto el mutex
+	int traspaso; // si se cede al primer proceso esperando al liberarlo
+	int sig_libre; // siguiente entrada de la lista de libres, si esta libre
 	lista_BCPs procesos_esperando; //procesos bloqueados
+	mutex_usuario compartido; // palabra de bloqueo, tipo y nº de bloqueos, accesibles desde la biblioteca
 } mutex;
 
-mutex tabla_mutex[NUM_MUT]; // variable global que representa todos los mutex del sistema
+/* proceso que tiene el mutex, -1 si esta libre */
+#define PROPIETARIO_MUTEX(mut) ((int)((mut)->compartido.palabra & ~MUTEX_ESPERANDO) - 1)
+
+/*
+ * La tabla de mutex crece por bloques de NUM_MUT hasta MAX_MUT. Los bloques
+ * no se mueven de sitio, ya que la biblioteca y los BCP apuntan a los mutex.
+ * Las entradas libres forman una lista por la que se reutilizan primero las
+ * liberadas mas recientemente
+ */
+mutex *bloques_mutex[MAX_MUT / NUM_MUT]; // bloques de la tabla de mutex
+
+int n_bloques_mutex; // bloques reservados hasta ahora
+
+int primer_mutex_libre; // cabeza de la lista de entradas libres, -1 si vacia
+
+/* mutex que ocupa la posicion pos de la tabla */
+#define MUTEX_POS(pos) (&bloques_mutex[(pos) / NUM_MUT][(pos) % NUM_MUT])
+
+/* numero de entradas de la tabla de mutex reservadas hasta ahora */
+#define TAM_TABLA_MUTEX (n_bloques_mutex * NUM_MUT)
 
 int n_mutex_open; // numero de mutex abiertos actualmente
 
+pagina_usuario pagina_usr; // zona del kernel accesible desde la biblioteca de servicios
+
 /*
-* Buffer de caracteres asociado al terminal
+ * Definicion de los cerrojos de lectores/escritores
+ */
+#define NUM_RWLOCK 16 /* numero total de cerrojos en el sistema */
+
+/* opcion de creacion: los escritores que esperan no dejan pasar a nuevos lectores */
+#define RW_PREFERENCIA_ESCRITOR 1
+
+/* modo en que un descriptor tiene cogido el cerrojo */
+#define RW_LECTURA 1
+#define RW_ESCRITURA 2
+
+typedef struct rwlock_t {
+	char nombre[MAX_NOM_MUT + 1]; // nombre
+	int estado; // entrada sin usar o en uso
+	int pref_escritor; // si se da preferencia a los escritores
+	int n_lectores; // lectores que lo tienen cogido
+	int escritor; // proceso que lo tiene cogido para escribir, -1 si ninguno
+	int n_opens; // contador de descriptores abiertos
+	lista_BCPs lectores_esperando; // lectores bloqueados
+	lista_BCPs escritores_esperando; // escritores bloqueados
+} rwlock;
+
+rwlock tabla_rwlock[NUM_RWLOCK]; // cerrojos de lectores/escritores del sistema
+
+/*
+ * Definicion de los semaforos contadores
+ */
+#define NUM_SEM 16 /* numero total de semaforos en el sistema */
+
+typedef struct semaforo_t {
+	char nombre[MAX_NOM_MUT + 1]; // nombre
+	int estado; // entrada sin usar o en uso
+	int valor; // unidades disponibles
+	int n_opens; // contador de descriptores abiertos
+	lista_BCPs procesos_esperando; // procesos bloqueados en wait
+} semaforo;
+
+semaforo tabla_sem[NUM_SEM]; // semaforos del sistema
+
+/*
+ * Definicion de las variables condicion, que se usan junto a un mutex
+ */
+#define NUM_COND 16 /* numero total de variables condicion en el sistema */
+
+typedef struct condicion_t {
+	char nombre[MAX_NOM_MUT + 1]; // nombre
+	int estado; // entrada sin usar o en uso
+	int n_opens; // contador de descriptores abiertos
+	lista_BCPs procesos_esperando; // procesos bloqueados en wait
+} condicion;
+
+condicion tabla_cond[NUM_COND]; // variables condicion del sistema
+
+/*
+ * Definicion de las barreras: los procesos esperan en ellas hasta que
+ * llega el numero de participantes indicado al crearlas
+ */
+#define NUM_BARRERA 16 /* numero total de barreras en el sistema */
+
+typedef struct barrera_t {
+	char nombre[MAX_NOM_MUT + 1]; // nombre
+	int estado; // entrada sin usar o en uso
+	int n_participantes; // procesos que tienen que llegar para abrirla
+	int n_llegados; // procesos que ya han llegado en la fase actual
+	int n_opens; // contador de descriptores abiertos
+	lista_BCPs procesos_esperando; // procesos que esperan al resto
+} barrera;
+
+barrera tabla_barrera[NUM_BARRERA]; // barreras del sistema
+
+/*
+ * Definicion de los contadores: enteros con nombre que se modifican de
+ * forma atomica con una sola llamada al sistema
+ */
+#define NUM_CONTADOR 16 /* numero total de contadores en el sistema */
+
+typedef struct contador_t {
+	char nombre[MAX_NOM_MUT + 1]; // nombre
+	int estado; // entrada sin usar o en uso
+	int valor; // valor actual
+	int n_opens; // contador de descriptores abiertos
+	lista_BCPs procesos_esperando; // procesos esperando a que alcance un valor
+} contador;
+
+contador tabla_contador[NUM_CONTADOR]; // contadores del sistema
+
+/*
+ * Definicion de las tuberias: buffer circular acotado con nombre. Cada
+ * descriptor es un extremo de lectura o de escritura de la tuberia
+ */
+#define NUM_TUBERIA 8 /* numero total de tuberias en el sistema */
+
+#define TUB_LECTURA 0 /* abrir el extremo de lectura */
+#define TUB_ESCRITURA 1 /* abrir el extremo de escritura */
+
+typedef struct tuberia_t {
+	char nombre[MAX_NOM_MUT + 1]; // nombre
+	int estado; // entrada sin usar o en uso
+	char datos[TAM_TUBERIA]; // buffer circular
+	int primero; // posicion del primer byte pendiente de leer
+	int ocupados; // bytes pendientes de leer
+	int n_lectores; // descriptores abiertos del extremo de lectura
+	int n_escritores; // descriptores abiertos del extremo de escritura
+	int hubo_lector; // se ha abierto alguna vez para leer
+	int hubo_escritor; // se ha abierto alguna vez para escribir
+	lista_BCPs lectores_esperando; // procesos esperando a que haya datos
+	lista_BCPs escritores_esperando; // procesos esperando a que haya hueco
+} tuberia;
+
+tuberia tabla_tuberia[NUM_TUBERIA]; // tuberias del sistema
+
+/*
+ * Definicion de los segmentos de memoria compartida: zonas con nombre que
+ * reserva el kernel y a las que se asocian varios procesos
+ */
+#define NUM_MEMORIA 8 /* numero total de segmentos en el sistema */
+
+typedef struct memoria_t {
+	char nombre[MAX_NOM_MUT + 1]; // nombre
+	int estado; // entrada sin usar o en uso
+	void *dir; // zona de memoria del segmento
+	int tam; // tamaño de la zona
+	int n_opens; // procesos asociados (descriptores abiertos)
+	int destruido; // se ha quitado su nombre del indice
+} memoria;
+
+memoria tabla_memoria[NUM_MEMORIA]; // segmentos de memoria compartida
+
+/*
+ * Definicion de los buzones: colas acotadas de mensajes de TAM_MENSAJE
+ * bytes con nombre. La profundidad se fija al crearlos
+ */
+#define NUM_BUZON 8 /* numero total de buzones en el sistema */
+
+/* estadisticas de un buzon desde que se creo */
+typedef struct estad_buzon_t {
+	unsigned long enviados; // mensajes enviados
+	unsigned long traspasos; // enviados directamente a un receptor que esperaba
+	unsigned long recibidos; // mensajes recibidos
+	int max_ocupados; // maximo de mensajes en cola a la vez
+	unsigned long espera_envio; // ticks bloqueados los emisores
+	unsigned long espera_recepcion; // ticks bloqueados los receptores
+	int profundidad; // mensajes que caben en la cola
+	int ocupados; // mensajes en cola sin recibir
+} estad_buzon;
+
+typedef struct buzon_t {
+	char nombre[MAX_NOM_MUT + 1]; // nombre
+	int estado; // entrada sin usar o en uso
+	char mensajes[MAX_MENSAJES_BUZON][TAM_MENSAJE]; // cola circular
+	int profundidad; // mensajes de la cola que se usan
+	int primero; // posicion del primer mensaje pendiente
+	int ocupados; // mensajes pendientes de recibir
+	int n_opens; // contador de descriptores abiertos
+	estad_buzon estad; // estadisticas
+	lista_BCPs emisores; // procesos esperando a que haya hueco
+	lista_BCPs receptores; // procesos esperando a que llegue un mensaje
+} buzon;
+
+buzon tabla_buzon[NUM_BUZON]; // buzones del sistema
+
+/*
+ * Indice hash de nombres: tabla de direccionamiento abierto con sondeo
+ * lineal que asocia el nombre de un objeto con su posicion en la tabla
+ * del sistema. Cada entrada apunta al nombre guardado en el propio objeto.
+ * El tamaño debe ser potencia de 2 y mayor que el numero de objetos.
+ */
+#define TAM_HASH_MUT 128 /* entradas del indice de nombres de mutex (> MAX_MUT) */
+
+#define HASH_VACIA -1
+
+typedef struct {
+	char *nombre; // nombre del objeto (no es una copia)
+	int pos; // posicion en la tabla de objetos o HASH_VACIA
+} entrada_hash;
+
+entrada_hash hash_mutex[TAM_HASH_MUT]; // indice de nombres de tabla_mutex
+
+#define TAM_HASH_RWLOCK 32 /* entradas del indice de nombres de cerrojos */
+
+entrada_hash hash_rwlock[TAM_HASH_RWLOCK]; // indice de nombres de tabla_rwlock
+
+#define TAM_HASH_SEM 32 /* entradas del indice de nombres de semaforos */
+
+entrada_hash hash_sem[TAM_HASH_SEM]; // indice de nombres de tabla_sem
+
+#define TAM_HASH_COND 32 /* entradas del indice de nombres de variables condicion */
+
+entrada_hash hash_cond[TAM_HASH_COND]; // indice de nombres de tabla_cond
+
+#define TAM_HASH_BARRERA 32 /* entradas del indice de nombres de barreras */
+
+entrada_hash hash_barrera[TAM_HASH_BARRERA]; // indice de nombres de tabla_barrera
+
+#define TAM_HASH_CONTADOR 32 /* entradas del indice de nombres de contadores */
+
+entrada_hash hash_contador[TAM_HASH_CONTADOR]; // indice de nombres de tabla_contador
+
+#define TAM_HASH_TUBERIA 16 /* entradas del indice de nombres de tuberias */
+
+entrada_hash hash_tuberia[TAM_HASH_TUBERIA]; // indice de nombres de tabla_tuberia
+
+#define TAM_HASH_MEMORIA 16 /* entradas del indice de nombres de memoria compartida */
+
+entrada_hash hash_memoria[TAM_HASH_MEMORIA]; // indice de nombres de tabla_memoria
+
+#define TAM_HASH_BUZON 16 /* entradas del indice de nombres de buzones */
+
+entrada_hash hash_buzon[TAM_HASH_BUZON]; // indice de nombres de tabla_buzon
+
+/*
+* Buffer circular de caracteres asociado al terminal
 */
 char bufferTerminal[TAM_BUF_TERM];
 
+int primerCaracter = 0; // posicion del siguiente caracter a leer
+
 int contCaracteres = 0; // contador de caracteres en el buffer
 
+int contDisponibles = 0; // caracteres del buffer que ya se pueden leer
+
+int modoTerminal = TERM_CARACTER; // TERM_CARACTER o TERM_LINEA
+
+/*
+* Cola circular de la salida de los procesos por consola, que se escribe
+* en trozos grandes en cada tick de reloj o cuando no hay nada que hacer
+*/
+char colaConsola[TAM_COLA_CONSOLA];
+
+int primeroConsola = 0; // posicion del primer caracter pendiente
+
+int contConsola = 0; // caracteres pendientes de escribir
+int vaciandoConsola = 0; // hay un vaciado de la cola en curso
+
+/*
+ * Los mensajes del kernel vacian antes la cola de salida por consola, para
+ * que la traza siga reflejando el orden en que han ocurrido las cosas
+ */
+void vaciar_consola();
+
+#define printk(...) (vaciar_consola(), printk(__VA_ARGS__))
+
+/*
+ * Niveles de los mensajes del kernel. Solo se escriben los de nivel menor o
+ * igual que nivel_log, que se cambia con la llamada fijar_nivel_log. Los de
+ * traza, que se producen en cada interrupcion y cambio de contexto, se
+ * eliminan del todo compilando con SIN_TRAZA (make SIN_TRAZA=1)
+ */
+#define LOG_ERROR 0 /* llamadas con parametros erroneos */
+#define LOG_AVISO 1 /* situaciones anomalas, como un proceso abortado */
+#define LOG_INFO 2 /* creacion y fin de procesos */
+#define LOG_TRAZA 3 /* interrupciones y cambios de contexto */
+
+int nivel_log = LOG_TRAZA;
+
+#define printk_nivel(nivel, ...) ((nivel) <= nivel_log ? printk(__VA_ARGS__) : 0)
+#define printk_error(...) printk_nivel(LOG_ERROR, __VA_ARGS__)
+#define printk_aviso(...) printk_nivel(LOG_AVISO, __VA_ARGS__)
+#define printk_info(...) printk_nivel(LOG_INFO, __VA_ARGS__)
+#ifdef SIN_TRAZA
+#define printk_traza(...) ((void)0)
+#else
+#define printk_traza(...) printk_nivel(LOG_TRAZA, __VA_ARGS__)
+#endif
+
+/* contadores del terminal desde el arranque */
+typedef struct estad_terminal_t {
+	unsigned long recibidos; // caracteres que han llegado del terminal
+	unsigned long consumidos; // caracteres leidos por los procesos
+	unsigned long perdidos; // caracteres descartados por estar lleno el buffer
+	int tam_buffer; // capacidad del buffer (TAM_BUF_TERM)
+	int pendientes; // caracteres en el buffer sin leer
+} estad_terminal;
+
+estad_terminal estad_term;
+
+/* Tipos de evento de esperar_eventos */
+#define EVENTO_TERMINAL 1 /* hay caracteres que leer */
+#define EVENTO_MUTEX 2 /* el mutex id esta libre */
+
+#define MAX_EVENTOS (NUM_DESC_PROC + 1) /* cada mutex abierto y el terminal */
+
+/* cada uno de los eventos que se pasan a esperar_eventos */
+typedef struct evento_t {
+	int tipo; // EVENTO_TERMINAL o EVENTO_MUTEX
+	unsigned int id; // descriptor del mutex
+	int listo; // a la vuelta, si se ha producido
+} evento;
+
 
 /*
  * Prototipos de las rutinas que realizan cada llamada al sistema
@@ -181,6 +616,64 @@ int sis_lock();
 int sis_unlock();
 int sis_cerrar_mutex();
 int sis_leer_caracter();
+int sis_volcar_estad_int();
+int sis_pagina_usuario();
+int sis_fijar_prioridad();
+int sis_crear_rwlock();
+int sis_abrir_rwlock();
+int sis_lock_lectura();
+int sis_lock_escritura();
+int sis_unlock_rw();
+int sis_cerrar_rwlock();
+int sis_crear_sem();
+int sis_abrir_sem();
+int sis_wait_sem();
+int sis_signal_sem();
+int sis_cerrar_sem();
+int sis_crear_cond();
+int sis_abrir_cond();
+int sis_wait_cond();
+int sis_signal_cond();
+int sis_broadcast_cond();
+int sis_cerrar_cond();
+int sis_trylock();
+int sis_lock_timeout();
+int sis_lock_varios();
+int sis_unlock_varios();
+int sis_leer_estad_mutex();
+int sis_crear_barrera();
+int sis_abrir_barrera();
+int sis_barrera_esperar();
+int sis_cerrar_barrera();
+int sis_crear_contador();
+int sis_abrir_contador();
+int sis_contador_leer();
+int sis_contador_sumar();
+int sis_contador_cas();
+int sis_contador_esperar();
+int sis_cerrar_contador();
+int sis_leer_estad_terminal();
+int sis_leer();
+int sis_fijar_modo_terminal();
+int sis_leer_timeout();
+int sis_esperar_eventos();
+int sis_fijar_nivel_log();
+int sis_leer_traza();
+int sis_crear_tuberia();
+int sis_abrir_tuberia();
+int sis_leer_tuberia();
+int sis_escribir_tuberia();
+int sis_cerrar_tuberia();
+int sis_crear_memoria();
+int sis_asociar_memoria();
+int sis_desasociar_memoria();
+int sis_destruir_memoria();
+int sis_crear_buzon();
+int sis_abrir_buzon();
+int sis_enviar_mensaje();
+int sis_recibir_mensaje();
+int sis_cerrar_buzon();
+int sis_leer_estad_buzon();
 
 /*
  * Variable global que contiene las rutinas que realizan cada llamada
@@ -197,6 +690,64 @@ servicio tabla_servicios[NSERVICIOS] = {
 	{sis_lock},
 	{sis_unlock},
 	{sis_cerrar_mutex},
-	{sis_leer_caracter}};
+	{sis_leer_caracter},
+	{sis_volcar_estad_int},
+	{sis_pagina_usuario},
+	{sis_fijar_prioridad},
+	{sis_crear_rwlock},
+	{sis_abrir_rwlock},
+	{sis_lock_lectura},
+	{sis_lock_escritura},
+	{sis_unlock_rw},
+	{sis_cerrar_rwlock},
+	{sis_crear_sem},
+	{sis_abrir_sem},
+	{sis_wait_sem},
+	{sis_signal_sem},
+	{sis_cerrar_sem},
+	{sis_crear_cond},
+	{sis_abrir_cond},
+	{sis_wait_cond},
+	{sis_signal_cond},
+	{sis_broadcast_cond},
+	{sis_cerrar_cond},
+	{sis_trylock},
+	{sis_lock_timeout},
+	{sis_lock_varios},
+	{sis_unlock_varios},
+	{sis_leer_estad_mutex},
+	{sis_crear_barrera},
+	{sis_abrir_barrera},
+	{sis_barrera_esperar},
+	{sis_cerrar_barrera},
+	{sis_crear_contador},
+	{sis_abrir_contador},
+	{sis_contador_leer},
+	{sis_contador_sumar},
+	{sis_contador_cas},
+	{sis_contador_esperar},
+	{sis_cerrar_contador},
+	{sis_leer_estad_terminal},
+	{sis_leer},
+	{sis_fijar_modo_terminal},
+	{sis_leer_timeout},
+	{sis_esperar_eventos},
+	{sis_fijar_nivel_log},
+	{sis_leer_traza},
+	{sis_crear_tuberia},
+	{sis_abrir_tuberia},
+	{sis_leer_tuberia},
+	{sis_escribir_tuberia},
+	{sis_cerrar_tuberia},
+	{sis_crear_memoria},
+	{sis_asociar_memoria},
+	{sis_desasociar_memoria},
+	{sis_destruir_memoria},
+	{sis_crear_buzon},
+	{sis_abrir_buzon},
+	{sis_enviar_mensaje},
+	{sis_recibir_mensaje},
+	{sis_cerrar_buzon},
+	{sis_leer_estad_buzon}};
 
 #endif /* _KERNEL_H */
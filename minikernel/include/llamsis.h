@@ -18,8 +18,10 @@
 #ifndef _LLAMSIS_H
 #define _LLAMSIS_H
 
+#include "const.h"
+
 /* Numero de llamadas disponibles */
-#define NSERVICIOS 12
+#define NSERVICIOS 70
 
 #define CREAR_PROCESO 0
 #define TERMINAR_PROCESO 1
@@ -33,6 +35,118 @@
 #define UNLOCK 9
 #define CERRAR_MUTEX 10
 #define LEER_CARACTER 11
+#define VOLCAR_ESTAD_INT 12
+#define PAGINA_USUARIO 13 /* uso interno de la biblioteca */
+#define FIJAR_PRIORIDAD 14
+#define CREAR_RWLOCK 15
+#define ABRIR_RWLOCK 16
+#define LOCK_LECTURA 17
+#define LOCK_ESCRITURA 18
+#define UNLOCK_RW 19
+#define CERRAR_RWLOCK 20
+#define CREAR_SEM 21
+#define ABRIR_SEM 22
+#define WAIT_SEM 23
+#define SIGNAL_SEM 24
+#define CERRAR_SEM 25
+#define CREAR_COND 26
+#define ABRIR_COND 27
+#define WAIT_COND 28
+#define SIGNAL_COND 29
+#define BROADCAST_COND 30
+#define CERRAR_COND 31
+#define TRYLOCK 32
+#define LOCK_TIMEOUT 33
+#define LOCK_VARIOS 34
+#define UNLOCK_VARIOS 35
+#define LEER_ESTAD_MUTEX 36
+#define CREAR_BARRERA 37
+#define ABRIR_BARRERA 38
+#define BARRERA_ESPERAR 39
+#define CERRAR_BARRERA 40
+#define CREAR_CONTADOR 41
+#define ABRIR_CONTADOR 42
+#define CONTADOR_LEER 43
+#define CONTADOR_SUMAR 44
+#define CONTADOR_CAS 45
+#define CONTADOR_ESPERAR 46
+#define CERRAR_CONTADOR 47
+#define LEER_ESTAD_TERMINAL 48
+#define LEER 49
+#define FIJAR_MODO_TERMINAL 50
+#define LEER_TIMEOUT 51
+#define ESPERAR_EVENTOS 52
+#define FIJAR_NIVEL_LOG 53
+#define LEER_TRAZA 54
+#define CREAR_TUBERIA 55
+#define ABRIR_TUBERIA 56
+#define LEER_TUBERIA 57
+#define ESCRIBIR_TUBERIA 58
+#define CERRAR_TUBERIA 59
+#define CREAR_MEMORIA 60
+#define ASOCIAR_MEMORIA 61
+#define DESASOCIAR_MEMORIA 62
+#define DESTRUIR_MEMORIA 63
+#define CREAR_BUZON 64
+#define ABRIR_BUZON 65
+#define ENVIAR_MENSAJE 66
+#define RECIBIR_MENSAJE 67
+#define CERRAR_BUZON 68
+#define LEER_ESTAD_BUZON 69
+
+/*
+ *
+ * Definiciones compartidas entre el kernel y la biblioteca de servicios.
+ * La biblioteca obtiene con PAGINA_USUARIO la direccion de una zona del
+ * kernel que puede leer y escribir directamente, lo que permite a lock y
+ * unlock adquirir y liberar un mutex libre sin hacer ninguna llamada al
+ * sistema. Solo se entra al kernel cuando hay contencion.
+ *
+ */
+
+/* bit de la palabra de un mutex que indica que hay procesos esperando */
+#define MUTEX_ESPERANDO 0x80000000u
+
+/* estadisticas de uso de un mutex, con los tiempos en ticks de reloj */
+typedef struct estad_mutex_t {
+	unsigned long adquisiciones; /* veces que se ha cogido, sin contar
+					los bloqueos recursivos */
+	unsigned long con_espera; /* adquisiciones en las que hubo que esperar */
+	unsigned long espera_total; /* ticks esperando en procesos_esperando */
+	unsigned long espera_max;
+	unsigned long posesion_total; /* ticks que ha estado cogido */
+	unsigned long posesion_max;
+	int max_esperando; /* maximo de procesos esperando a la vez */
+} estad_mutex;
+
+/* parte de un mutex visible desde la biblioteca */
+typedef struct mutex_usuario_t {
+	volatile unsigned int palabra; /* 0 si esta libre; si no, id del
+					  propietario + 1, mas MUTEX_ESPERANDO */
+	int n_blocks; /* veces que el propietario lo tiene bloqueado */
+	int tipo; /* RECURSIVO o NO_RECURSIVO */
+	unsigned long inicio_posesion; /* tick en el que lo cogio el propietario */
+	estad_mutex estad; /* la biblioteca anota los lock y unlock sin contencion */
+} mutex_usuario;
+
+/* buffer de salida de un proceso, que escribir solo vuelca al kernel
+   cuando toca segun el modo (el 0 es el modo linea, el de defecto) */
+typedef struct salida_usuario_t {
+	int modo; /* SALIDA_LINEA, SALIDA_COMPLETA o SALIDA_SIN_BUFFER */
+	int ocupados; /* caracteres pendientes de escribir */
+	char datos[TAM_BUF_SALIDA];
+} salida_usuario;
+
+typedef struct pagina_usuario_t {
+	volatile int id_actual; /* proceso en ejecucion */
+	volatile unsigned long ticks; /* interrupciones de reloj desde el arranque */
+	/* mutex al que se refiere cada descriptor de cada proceso, NULL si
+	   el descriptor no esta abierto o no es un mutex */
+	mutex_usuario *mutex[MAX_PROC][NUM_DESC_PROC];
+	/* la salida pendiente de cada proceso; si muere sin vaciarla lo
+	   hace el kernel */
+	salida_usuario salida[MAX_PROC];
+} pagina_usuario;
 
 
 #endif /* _LLAMSIS_H */
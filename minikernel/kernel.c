@@ -15,6 +15,105 @@
 
 #include "kernel.h" /* Contiene defs. usadas por este modulo */
 
+/****************************************************************************************
+ * Funciones de instrumentacion del nivel de interrupcion:
+ *	leer_reloj_host buscar_sitio_int fijar_nivel_int_instr
+ */
+
+/*
+ * Devuelve una marca de tiempo del host en nanosegundos. leer_reloj_CMOS
+ * solo tiene resolucion de milisegundos, insuficiente para estas secciones.
+ */
+static unsigned long long leer_reloj_host()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * Funcion que devuelve la entrada de estadisticas de un punto de llamada,
+ * dandola de alta si es la primera vez. Devuelve -1 si la tabla esta llena.
+ */
+static int buscar_sitio_int(const char *funcion, int linea)
+{
+	int i;
+
+	for (i = 0; i < n_sitios_int; i++)
+		if (tabla_estad_int[i].linea == linea && tabla_estad_int[i].funcion == funcion)
+			return i;
+
+	if (n_sitios_int == MAX_SITIOS_INT)
+		return -1;
+
+	tabla_estad_int[i].funcion = funcion;
+	tabla_estad_int[i].linea = linea;
+	tabla_estad_int[i].veces = 0;
+	tabla_estad_int[i].total_ns = 0;
+	tabla_estad_int[i].max_ns = 0;
+	n_sitios_int++;
+	return i;
+}
+
+/*
+ * Envoltorio de fijar_nivel_int del HAL (la macro de kernel.h redirige aqui
+ * todas las llamadas). Abre una seccion al pasar a NIVEL_3 desde un nivel
+ * inferior y la cierra, imputandola al sitio que la abrio, al bajar de el.
+ */
+int fijar_nivel_int_instr(int nivel, const char *funcion, int linea)
+{
+	int previo, sitio;
+	unsigned long long duracion;
+
+	// se cierra la seccion antes de volver a habilitar las interrupciones
+	if (nivel < NIVEL_3 && sitio_int_actual != -1)
+	{
+		sitio = sitio_int_actual;
+		sitio_int_actual = -1;
+		duracion = leer_reloj_host() - inicio_seccion_int;
+		tabla_estad_int[sitio].veces++;
+		tabla_estad_int[sitio].total_ns += duracion;
+		if (duracion > tabla_estad_int[sitio].max_ns)
+			tabla_estad_int[sitio].max_ns = duracion;
+	}
+
+	previo = (fijar_nivel_int)(nivel);
+
+	// se abre una seccion nueva solo si realmente se eleva el nivel
+	if (nivel == NIVEL_3 && previo < NIVEL_3)
+	{
+		sitio_int_actual = buscar_sitio_int(funcion, linea);
+		inicio_seccion_int = leer_reloj_host();
+	}
+
+	return previo;
+}
+
+/****************************************************************************************
+ * Funciones de la traza binaria de sucesos:
+ *	anotar_traza
+ */
+
+/*
+ * Anota un suceso en el buffer circular de la traza, machacando el mas
+ * antiguo si esta lleno. Se puede llamar desde las interrupciones
+ */
+void anotar_traza(int tipo, int proc, int dato)
+{
+	suceso_traza *s;
+	int nivel_previo;
+
+	nivel_previo = fijar_nivel_int(NIVEL_3);
+	s = &traza[n_sucesos % TAM_TRAZA];
+	n_sucesos++;
+	s->instante = leer_reloj_host();
+	s->tipo = tipo;
+	s->proc = proc;
+	s->dato = dato;
+	fijar_nivel_int(nivel_previo);
+}
+
 /****************************************************************************************
  * Funciones relacionadas con la tabla de procesos:
  *	iniciar_tabla_proc buscar_BCP_libre
@@ -46,7 +145,7 @@ static int buscar_BCP_libre()
 
 /****************************************************************************************
  * Funciones que facilitan el manejo de las listas de BCPs
- *	insertar_ultimo eliminar_primero eliminar_elem
+ *	insertar_ultimo insertar_primero eliminar_primero eliminar_elem
  *
  * NOTA: PRIMERO SE DEBE LLAMAR A eliminar Y LUEGO A insertar
  */
@@ -64,6 +163,17 @@ static void insertar_ultimo(lista_BCPs *lista, BCP *proc)
 	proc->siguiente = NULL;
 }
 
+/*
+ * Inserta un BCP al principio de la lista.
+ */
+static void insertar_primero(lista_BCPs *lista, BCP *proc)
+{
+	if (lista->primero == NULL)
+		lista->ultimo = proc;
+	proc->siguiente = lista->primero;
+	lista->primero = proc;
+}
+
 /*
  * Elimina el primer BCP de la lista.
  */
@@ -99,38 +209,171 @@ static void eliminar_elem(lista_BCPs *lista, BCP *proc)
 }
 
 /****************************************************************************************
- * Funciones relacionadas con la tabla de mutex:
- * iniciar_tabla_mutex, buscar_mutex_libre, buscar_nombre_mutex
- * find_mutex_descrp, get_free_mutex_descrp, get_open_mutex
- * desbloquear_proc_esperando, liberar_mutex
+ * Funciones del indice hash de nombres:
+ *	iniciar_hash hash_nombre buscar_hash insertar_hash eliminar_hash
  */
 
 /*
- * Funcion que inicia la tabla de mutex
+ * Funcion que deja vacias todas las entradas de un indice
  */
-static void iniciar_tabla_mutex()
+static void iniciar_hash(entrada_hash *tabla, int tam)
 {
 	int i;
 
+	for (i = 0; i < tam; i++)
+		tabla[i].pos = HASH_VACIA;
+}
+
+/*
+ * Funcion de dispersion FNV-1a sobre el nombre
+ */
+static unsigned int hash_nombre(char *nombre)
+{
+	unsigned int h = 2166136261u;
+
+	for (; *nombre; nombre++)
+	{
+		h ^= (unsigned char)*nombre;
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/*
+ * Funcion que busca un nombre en el indice.
+ * Devuelve la posicion del objeto en su tabla o -1 si no existe
+ */
+static int buscar_hash(entrada_hash *tabla, int tam, char *nombre)
+{
+	unsigned int i;
+
+	for (i = hash_nombre(nombre) & (tam - 1); tabla[i].pos != HASH_VACIA;
+		 i = (i + 1) & (tam - 1))
+	{
+		if (strcmp(tabla[i].nombre, nombre) == 0)
+			return tabla[i].pos;
+	}
+	return -1;
+}
+
+/*
+ * Funcion que da de alta un nombre en el indice. El nombre debe apuntar a
+ * memoria del propio objeto y no puede estar ya en el indice.
+ */
+static void insertar_hash(entrada_hash *tabla, int tam, char *nombre, int pos)
+{
+	unsigned int i;
+
+	for (i = hash_nombre(nombre) & (tam - 1); tabla[i].pos != HASH_VACIA;
+		 i = (i + 1) & (tam - 1))
+		;
+	tabla[i].nombre = nombre;
+	tabla[i].pos = pos;
+}
+
+/*
+ * Funcion que da de baja un nombre del indice. En vez de dejar marcas de
+ * borrado se recolocan las entradas siguientes de la misma secuencia de
+ * sondeo, de modo que las busquedas no se degradan con el uso.
+ */
+static void eliminar_hash(entrada_hash *tabla, int tam, char *nombre)
+{
+	unsigned int i, j, ideal;
+
+	for (i = hash_nombre(nombre) & (tam - 1); tabla[i].pos != HASH_VACIA;
+		 i = (i + 1) & (tam - 1))
+	{
+		if (strcmp(tabla[i].nombre, nombre) == 0)
+			break;
+	}
+	if (tabla[i].pos == HASH_VACIA)
+		return;
+
+	// se rellena el hueco con las entradas posteriores que lo necesiten
+	for (j = (i + 1) & (tam - 1); tabla[j].pos != HASH_VACIA; j = (j + 1) & (tam - 1))
+	{
+		ideal = hash_nombre(tabla[j].nombre) & (tam - 1);
+		// la entrada j puede ocupar el hueco i si i esta entre su posicion ideal y j
+		if (((j - ideal) & (tam - 1)) >= ((j - i) & (tam - 1)))
+		{
+			tabla[i] = tabla[j];
+			i = j;
+		}
+	}
+	tabla[i].pos = HASH_VACIA;
+}
+
+/****************************************************************************************
+ * Funciones relacionadas con la tabla de mutex:
+ * ampliar_tabla_mutex, iniciar_tabla_mutex, hay_mutex_libre,
+ * tomar_mutex_libre, buscar_nombre_mutex
+ * reservar_descriptor, liberar_descriptor, obtener_objeto, obtener_mutex
+ * desbloquear_proc_esperando, desbloquear_proceso, desbloquear_todos,
+ * recalcular_prioridad,
+ * anotar_adquisicion, anotar_posesion, soltar_mutex, destruir_mutex,
+ * cerrar_desc_mutex
+ */
+
+/*
+ * Funcion que añade un bloque de entradas libres a la tabla de mutex.
+ * Devuelve -1 si se ha alcanzado MAX_MUT o no hay memoria
+ */
+static int ampliar_tabla_mutex()
+{
+	int i, base;
+	mutex *bloque;
+
+	if (n_bloques_mutex == MAX_MUT / NUM_MUT)
+		return -1;
+	bloque = malloc(NUM_MUT * sizeof(mutex));
+	if (bloque == NULL)
+		return -1;
+
+	// las nuevas entradas se encadenan en orden delante de la lista de libres
+	base = TAM_TABLA_MUTEX;
 	for (i = 0; i < NUM_MUT; i++)
 	{
-		tabla_mutex[i].estado = SIN_USAR;
+		bloque[i].estado = SIN_USAR;
+		bloque[i].id = base + i;
+		bloque[i].sig_libre = i + 1 < NUM_MUT ? base + i + 1 : primer_mutex_libre;
 	}
+	bloques_mutex[n_bloques_mutex++] = bloque;
+	primer_mutex_libre = base;
+	return 0;
+}
+
+/*
+ * Funcion que inicia la tabla de mutex
+ */
+static void iniciar_tabla_mutex()
+{
+	n_bloques_mutex = 0;
+	primer_mutex_libre = -1;
+	if (ampliar_tabla_mutex() < 0)
+		panico("no hay memoria para la tabla de mutex");
+	iniciar_hash(hash_mutex, TAM_HASH_MUT);
 
 	n_mutex_open = 0;
 }
 
 /*
- * Funci�n que busca una entrada libre en la tabla de mutex
+ * Funcion que indica si se puede crear un mutex, ampliando la tabla si hace falta
  */
-static int buscar_mutex_libre()
+static int hay_mutex_libre()
 {
-	int i;
+	return primer_mutex_libre != -1 || ampliar_tabla_mutex() == 0;
+}
 
-	for (i = 0; i < NUM_MUT; i++)
-		if (tabla_mutex[i].estado == SIN_USAR)
-			return i;
-	return -1;
+/*
+ * Funcion que saca una entrada de la lista de libres de la tabla de mutex.
+ * Solo se debe llamar si hay_mutex_libre() es cierto
+ */
+static int tomar_mutex_libre()
+{
+	int pos = primer_mutex_libre;
+
+	primer_mutex_libre = MUTEX_POS(pos)->sig_libre;
+	return pos;
 }
 
 /*
@@ -140,102 +383,325 @@ static int buscar_mutex_libre()
  */
 static int buscar_nombre_mutex(char *nombre)
 {
-	int i;
+	return buscar_hash(hash_mutex, TAM_HASH_MUT, nombre);
+}
 
-	for (i = 0; i < NUM_MUT; i++)
-	{
-		if (tabla_mutex[i].estado != SIN_USAR && strcmp(tabla_mutex[i].nombre, nombre) == 0)
-			return i;
-	}
-	return -1;
+// Rutina que reserva el primer descriptor libre del proceso actual y lo asocia
+// al objeto indicado. Devuelve el descriptor o -1 si no quedan libres
+int reservar_descriptor(int tipo, int obj)
+{
+	int desc;
+
+	if (p_proc_actual->descs_libres == 0)
+		return -1;
+
+	desc = __builtin_ctz(p_proc_actual->descs_libres);
+	p_proc_actual->descs_libres &= ~(1u << desc);
+	p_proc_actual->descs[desc].tipo = tipo;
+	p_proc_actual->descs[desc].obj = obj;
+	p_proc_actual->descs[desc].cogido = 0;
+	return desc;
 }
 
-// Rutina que busca si el proceso actual tiene abierto el mutex con identificador id
-int find_mutex_descrp(int id)
+// Rutina que devuelve un descriptor del proceso actual a la lista de libres
+void liberar_descriptor(int desc)
 {
-	int i;
-	for (i = 0; i < NUM_MUT_PROC; i++)
-	{
-		if (p_proc_actual->desc_mutex[i] == id)
-			return i;
-	}
-	return -1;
+	p_proc_actual->descs_libres |= 1u << desc;
+	pagina_usr.mutex[p_proc_actual->id][desc] = NULL;
 }
 
-// Rutina que dado un proceso, devuelve el primer descriptor de mutex libre que tenga, -1 si no hay
-int get_free_mutex_descrp()
+// Rutina que asocia un descriptor libre del proceso actual a un mutex y
+// lo publica en la pagina de usuario para que lock y unlock lo vean
+int reservar_descriptor_mutex(int pos)
 {
-	return find_mutex_descrp(-1);
+	int desc;
+
+	desc = reservar_descriptor(DESC_MUTEX, pos);
+	if (desc != -1)
+		pagina_usr.mutex[p_proc_actual->id][desc] = &MUTEX_POS(pos)->compartido;
+	return desc;
 }
 
-// Rutina que dado el id de un mutex busca si el proceso actual tiene abierto el mutex
-int get_open_mutex(int mutexid)
+// Rutina que dado un descriptor del proceso actual devuelve la posicion del
+// objeto al que se refiere, -1 si no esta abierto o no es del tipo indicado
+int obtener_objeto(unsigned int desc, int tipo)
 {
-	int i;
-	for (i = 0; i < NUM_MUT_PROC; i++)
+	if (desc >= NUM_DESC_PROC || (p_proc_actual->descs_libres & (1u << desc)) ||
+		p_proc_actual->descs[desc].tipo != tipo)
+		return -1;
+
+	return p_proc_actual->descs[desc].obj;
+}
+
+// Rutina que dice si al proceso actual le queda algun descriptor abierto
+// que se refiera al objeto obj del tipo indicado
+int objeto_abierto(int tipo, int obj)
+{
+	int desc;
+	unsigned int abiertos;
+
+	abiertos = ~p_proc_actual->descs_libres & DESCS_TODOS_LIBRES;
+	for (; abiertos != 0; abiertos &= abiertos - 1)
 	{
-		if (p_proc_actual->desc_mutex[i] == mutexid)
-			return i;
+		desc = __builtin_ctz(abiertos);
+		if (p_proc_actual->descs[desc].tipo == tipo && p_proc_actual->descs[desc].obj == obj)
+			return 1;
 	}
-	return -1;
+	return 0;
+}
+
+// Rutina que dado un descriptor del proceso actual devuelve el mutex al que se
+// refiere, NULL si el descriptor no esta abierto o no corresponde a un mutex
+mutex *obtener_mutex(unsigned int desc)
+{
+	int pos = obtener_objeto(desc, DESC_MUTEX);
+
+	return pos == -1 ? NULL : MUTEX_POS(pos);
 }
 
 // dada una lista desbloquea al primer proceso esperando y lo mete en la lista de listos
 void desbloquear_proc_esperando(lista_BCPs *lista_bloqueos)
 {
 	int nivel_previo;
+	BCP *proceso_desbloqueado;
 
-	BCP *proceso_desbloqueado = lista_bloqueos->primero;
+	// se consulta con el reloj inhibido porque al vencer un plazo se saca
+	// al proceso de la lista en la que espera
+	nivel_previo = fijar_nivel_int(3);
+	proceso_desbloqueado = lista_bloqueos->primero;
 	if (proceso_desbloqueado != NULL)
 	{
-		nivel_previo = fijar_nivel_int(3);
 		proceso_desbloqueado->estado = LISTO;
+		anotar_traza(TRAZA_DESPERTAR, proceso_desbloqueado->id, 0);
 		// eliminamos al primer proceso esperando
 		eliminar_elem(lista_bloqueos, proceso_desbloqueado);
 		// insertamos proceso bloqueado en la lista de procesos esperando al mutex
 		insertar_ultimo(&lista_listos, proceso_desbloqueado);
-		fijar_nivel_int(nivel_previo);
 	}
+	fijar_nivel_int(nivel_previo);
 }
 
-// Funcion que libera todos los mutex del proceso actual.
-// Se llama al liberar un proceso
-void liberar_mutex()
+// saca de una lista de espera a un proceso concreto y lo mete en la de listos
+void desbloquear_proceso(lista_BCPs *lista_bloqueos, BCP *proc)
 {
-	int i, descriptor;
-	mutex *mut;
+	int nivel_previo;
+
+	nivel_previo = fijar_nivel_int(3);
+	proc->estado = LISTO;
+	anotar_traza(TRAZA_DESPERTAR, proc->id, 0);
+	eliminar_elem(lista_bloqueos, proc);
+	insertar_ultimo(&lista_listos, proc);
+	fijar_nivel_int(nivel_previo);
+}
 
-	for (i = 0; i < NUM_MUT_PROC; i++)
+// desbloquea a todos los procesos de una lista, en el orden en que esperaban.
+// La lista entera se engancha al final de la de listos en una sola operacion
+void desbloquear_todos(lista_BCPs *lista_bloqueos)
+{
+	int nivel_previo;
+	BCP *p;
+
+	nivel_previo = fijar_nivel_int(3);
+	if (lista_bloqueos->primero != NULL)
 	{
-		descriptor = p_proc_actual->desc_mutex[i];
-		// aquellos mutex que tenga abiertos se cierran
-		if (descriptor != -1)
+		for (p = lista_bloqueos->primero; p != NULL; p = p->siguiente)
 		{
-			mut = &tabla_mutex[descriptor];
+			p->estado = LISTO;
+			anotar_traza(TRAZA_DESPERTAR, p->id, 0);
+		}
 
-			p_proc_actual->desc_mutex[i] = -1;
-			// si el proceso actual tiene bloqueado el mutex
-			if (mut->owner == p_proc_actual->id && mut->estado == LOCKED)
-			{
-				mut->estado = UNLOCKED;
-				mut->n_blocks = 0; // cerramos todas las veces que se habia bloqueado por el proceso actual
-				// desbloqueamos procesos esperando por el mutex
-				desbloquear_proc_esperando(&mut->procesos_esperando);
-			}
+		if (lista_listos.primero == NULL)
+			lista_listos.primero = lista_bloqueos->primero;
+		else
+			lista_listos.ultimo->siguiente = lista_bloqueos->primero;
+		lista_listos.ultimo = lista_bloqueos->ultimo;
+		lista_bloqueos->primero = lista_bloqueos->ultimo = NULL;
+	}
+	fijar_nivel_int(nivel_previo);
+}
 
-			mut->n_opens--;
+// despierta a los procesos de esperar_eventos que esperan caracteres del
+// terminal (si terminal no es 0) o que quede libre el mutex mut. Al
+// despertar vuelven a mirar sus eventos y si no hay ninguno se bloquean
+void despertar_eventos(int terminal, mutex *mut)
+{
+	int nivel_previo, i, interesa;
+	BCP *p, *sig;
 
-			// si no hay nadie con el mutex abierto se elimina definitivamente
-			if (mut->n_opens <= 0)
-			{
-				tabla_mutex[descriptor].estado = SIN_USAR;
-				n_mutex_open--;
+	nivel_previo = fijar_nivel_int(3);
+	for (p = lista_bloq_eventos.primero; p != NULL; p = sig)
+	{
+		sig = p->siguiente;
+		interesa = terminal && p->eventos_terminal;
+		for (i = 0; i < p->n_eventos_mutex && !interesa; i++)
+			interesa = p->eventos_mutex[i] == mut;
+		if (interesa)
+			desbloquear_proceso(&lista_bloq_eventos, p);
+	}
+	fijar_nivel_int(nivel_previo);
+}
 
-				// desbloqueamos procesos esperando a crear un mutex si los habia
-				desbloquear_proc_esperando(&lista_bloq_mutex);
-			}
+// Funcion que recalcula la prioridad efectiva de un proceso: la mayor entre
+// su prioridad base y la de los procesos que esperan por mutex suyos. Si
+// cambia y el proceso esta a su vez esperando por un mutex, se propaga al
+// propietario de ese mutex, de modo que la herencia se encadena
+void recalcular_prioridad(BCP *proc)
+{
+	int desc, prio, propietario, saltos, nivel_previo;
+	unsigned int abiertos;
+	BCP *p;
+	mutex *mut;
+
+	// el reloj saca de las listas de espera a los que les vence el plazo
+	nivel_previo = fijar_nivel_int(NIVEL_3);
+
+	// el numero de saltos esta acotado por si hay un interbloqueo
+	for (saltos = 0; proc != NULL && saltos < MAX_PROC; saltos++)
+	{
+		prio = proc->prioridad_base;
+
+		// un proceso solo puede tener cogidos mutex que tenga abiertos
+		abiertos = ~proc->descs_libres & DESCS_TODOS_LIBRES;
+		for (; abiertos != 0; abiertos &= abiertos - 1)
+		{
+			desc = __builtin_ctz(abiertos);
+			if (proc->descs[desc].tipo != DESC_MUTEX)
+				continue;
+			mut = MUTEX_POS(proc->descs[desc].obj);
+			if (PROPIETARIO_MUTEX(mut) != proc->id)
+				continue;
+			for (p = mut->procesos_esperando.primero; p != NULL; p = p->siguiente)
+				if (p->prioridad > prio)
+					prio = p->prioridad;
 		}
+
+		if (prio == proc->prioridad)
+			break;
+		proc->prioridad = prio;
+
+		if (proc->mutex_esperado == NULL)
+			break;
+		propietario = PROPIETARIO_MUTEX(proc->mutex_esperado);
+		proc = propietario >= 0 ? &tabla_procs[propietario] : NULL;
+	}
+	fijar_nivel_int(nivel_previo);
+}
+
+// Funcion que anota en las estadisticas del mutex que proc acaba de cogerlo.
+// Si esperado es cierto ha estado esperando por el desde proc->inicio_espera
+void anotar_adquisicion(mutex *mut, BCP *proc, int esperado)
+{
+	estad_mutex *e = &mut->compartido.estad;
+	unsigned long espera;
+
+	anotar_traza(TRAZA_COGER_MUTEX, proc->id, mut->id);
+	mut->compartido.inicio_posesion = num_ints;
+	e->adquisiciones++;
+	if (esperado)
+	{
+		espera = num_ints - proc->inicio_espera;
+		e->con_espera++;
+		e->espera_total += espera;
+		if (espera > e->espera_max)
+			e->espera_max = espera;
+	}
+}
+
+// Funcion que anota en las estadisticas del mutex que su propietario lo suelta
+void anotar_posesion(mutex *mut)
+{
+	estad_mutex *e = &mut->compartido.estad;
+	unsigned long posesion = num_ints - mut->compartido.inicio_posesion;
+
+	e->posesion_total += posesion;
+	if (posesion > e->posesion_max)
+		e->posesion_max = posesion;
+}
+
+// Funcion que deja libre un mutex, sea cual sea el nº de veces que estaba
+// bloqueado, y desbloquea al primer proceso esperando por el si lo hay.
+// En modo traspaso el mutex pasa a ser directamente de ese proceso
+void soltar_mutex(mutex *mut)
+{
+	BCP *siguiente;
+	BCP *anterior = &tabla_procs[PROPIETARIO_MUTEX(mut)];
+	int nivel_previo;
+
+	anotar_posesion(mut);
+	anotar_traza(TRAZA_SOLTAR_MUTEX, anterior->id, mut->id);
+
+	// el que despierta se saca de la lista y, en modo traspaso, pasa a ser
+	// el propietario con el reloj inhibido, para que no le pueda vencer el
+	// plazo despues de elegido. Una vez listo el reloj ya no lo descuenta
+	nivel_previo = fijar_nivel_int(NIVEL_3);
+	siguiente = mut->procesos_esperando.primero;
+	if (siguiente != NULL)
+	{
+		siguiente->mutex_esperado = NULL;
+		desbloquear_proceso(&mut->procesos_esperando, siguiente);
+	}
+	if (mut->traspaso && siguiente != NULL)
+	{
+		mut->compartido.n_blocks = 1;
+		mut->compartido.palabra = (siguiente->id + 1) |
+								  (mut->procesos_esperando.primero ? MUTEX_ESPERANDO : 0);
+	}
+	else
+	{
+		mut->compartido.n_blocks = 0;
+		mut->compartido.palabra = 0;
+	}
+	fijar_nivel_int(nivel_previo);
+
+	if (mut->traspaso && siguiente != NULL)
+	{
+		anotar_adquisicion(mut, siguiente, 1);
+		// el nuevo propietario hereda de los que siguen esperando
+		recalcular_prioridad(siguiente);
 	}
+
+	// el anterior propietario deja de heredar de los que esperaban por el mutex
+	recalcular_prioridad(anterior);
+
+	// aunque se haya traspasado, quien lo espere en esperar_eventos tiene
+	// que marcarlo de nuevo para que el nuevo propietario entre al soltarlo
+	despertar_eventos(0, mut);
+}
+
+// Funcion que elimina definitivamente un mutex que ya nadie tiene abierto
+void destruir_mutex(mutex *mut)
+{
+	mut->estado = SIN_USAR;
+	eliminar_hash(hash_mutex, TAM_HASH_MUT, mut->nombre);
+	n_mutex_open--;
+
+	// la entrada se reutilizara la primera
+	mut->sig_libre = primer_mutex_libre;
+	primer_mutex_libre = mut->id;
+
+	// desbloqueamos procesos esperando a crear un mutex si los habia
+	desbloquear_proc_esperando(&lista_bloq_mutex);
+}
+
+// Funcion que cierra un descriptor de mutex del proceso actual, soltando
+// el mutex si lo tenia bloqueado y no lo tiene abierto con otro descriptor
+void cerrar_desc_mutex(int desc)
+{
+	int pos = obtener_objeto(desc, DESC_MUTEX);
+	mutex *mut = MUTEX_POS(pos);
+
+	// cerramos el descriptor del proceso actual
+	liberar_descriptor(desc);
+	mut->n_opens--;
+
+	// si ademas el proceso actual tiene bloqueado el mutex se libera, salvo
+	// que lo siga teniendo abierto por otro descriptor
+	if (PROPIETARIO_MUTEX(mut) == p_proc_actual->id && !objeto_abierto(DESC_MUTEX, pos))
+		soltar_mutex(mut);
+
+	// si no hay nadie con el mutex abierto se elimina definitivamente
+	if (mut->n_opens <= 0)
+		destruir_mutex(mut);
 }
 
 /****************************************************************************************
@@ -243,6 +709,46 @@ void liberar_mutex()
  *	espera_int planificador
  */
 
+/*
+ * Escribe en la consola todo lo pendiente en la cola de salida, en como
+ * mucho dos trozos si da la vuelta, y despierta a los procesos que
+ * esperaban sitio en ella. Solo se inhiben las interrupciones para tomar
+ * cada trozo y para darlo por escrito, no mientras se escribe. Si llega
+ * una interrupcion que quiere vaciar la cola durante la escritura, no hace
+ * nada y deja que termine el vaciado en curso
+ */
+void vaciar_consola()
+{
+	int nivel_previo, primero, n;
+
+	nivel_previo = fijar_nivel_int(NIVEL_3);
+	if (vaciandoConsola)
+	{
+		fijar_nivel_int(nivel_previo);
+		return;
+	}
+	vaciandoConsola = 1;
+	while (contConsola > 0)
+	{
+		primero = primeroConsola;
+		n = TAM_COLA_CONSOLA - primero;
+		if (n > contConsola)
+			n = contConsola;
+		fijar_nivel_int(nivel_previo);
+
+		// el trozo sigue contando como ocupado, asi que no se escribe
+		// encima de el mientras se vuelca
+		escribir_ker(&colaConsola[primero], n);
+
+		fijar_nivel_int(NIVEL_3);
+		primeroConsola = (primero + n) % TAM_COLA_CONSOLA;
+		contConsola -= n;
+	}
+	desbloquear_todos(&lista_bloq_escritura);
+	vaciandoConsola = 0;
+	fijar_nivel_int(nivel_previo);
+}
+
 /*
  * Espera a que se produzca una interrupcion
  */
@@ -250,7 +756,13 @@ static void espera_int()
 {
 	int nivel;
 
-	printk("-> NO HAY LISTOS. ESPERA INT\n");
+	// se aprovecha para escribir la salida pendiente, lo que puede haber
+	// despertado a algun proceso que esperaba sitio en la cola
+	vaciar_consola();
+	if (lista_listos.primero != NULL)
+		return;
+
+	printk_traza("-> NO HAY LISTOS. ESPERA INT\n");
 
 	/* Baja al m�nimo el nivel de interrupci�n mientras espera */
 	nivel = fijar_nivel_int(NIVEL_1);
@@ -259,709 +771,3214 @@ static void espera_int()
 }
 
 /*
- * Funci�n de planificacion que implementa un algoritmo FIFO.
+ * Funci�n de planificacion que implementa un algoritmo FIFO con prioridades.
  */
 static BCP *planificador()
 {
+	BCP *p, *elegido;
+	int nivel_previo;
+
+	// el proceso que deja la UCP puede hacerlo por bloquearse
+	if (p_proc_actual != NULL && p_proc_actual->estado == BLOQUEADO)
+		anotar_traza(TRAZA_BLOQUEO, p_proc_actual->id, 0);
+
 	while (lista_listos.primero == NULL)
 		espera_int(); /* No hay nada que hacer */
 
-	// le asignamos los ticks que tiene por rodaja
-	lista_listos.primero->ticks_rodaja_restantes = TICKS_POR_RODAJA;
-	return lista_listos.primero;
+	// se elige el primero de los de mayor prioridad efectiva y se pone en
+	// cabeza, que es donde se espera encontrar al proceso en ejecucion
+	elegido = lista_listos.primero;
+	for (p = elegido->siguiente; p != NULL; p = p->siguiente)
+		if (p->prioridad > elegido->prioridad)
+			elegido = p;
+
+	if (elegido != lista_listos.primero)
+	{
+		nivel_previo = fijar_nivel_int(NIVEL_3);
+		eliminar_elem(&lista_listos, elegido);
+		insertar_primero(&lista_listos, elegido);
+		fijar_nivel_int(nivel_previo);
+	}
+
+	if (lista_listos.primero != p_proc_actual)
+		anotar_traza(TRAZA_CAMBIO, p_proc_actual != NULL ? p_proc_actual->id : -1,
+					 lista_listos.primero->id);
+
+	// le asignamos los ticks que tiene por rodaja
+	lista_listos.primero->ticks_rodaja_restantes = TICKS_POR_RODAJA;
+	// la biblioteca identifica al proceso en ejecucion sin llamar al sistema
+	pagina_usr.id_actual = lista_listos.primero->id;
+	return lista_listos.primero;
 }
 
-/****************************************************************************************
- * Funcion auxiliar que termina proceso actual liberando sus recursos.
- * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
- *
+/*
+ * Bloquea al proceso actual en la lista indicada y cede el procesador.
+ * Retorna cuando otro proceso lo vuelve a poner en la lista de listos
  */
-static void liberar_proceso()
+static void bloquear_proceso_actual(lista_BCPs *lista)
 {
-	BCP *p_proc_anterior;
+	BCP *proc_a_bloquear;
 	int nivel_previo;
 
-	liberar_mutex();						 // liberamos mutex
-	liberar_imagen(p_proc_actual->info_mem); /* liberar mapa */
-
-	p_proc_actual->estado = TERMINADO;
 	nivel_previo = fijar_nivel_int(NIVEL_3);
-	eliminar_primero(&lista_listos); /* proc. fuera de listos */
+	p_proc_actual->estado = BLOQUEADO;
+	proc_a_bloquear = p_proc_actual;
+	// sacamos el proceso actual de la lista de listos
+	eliminar_elem(&lista_listos, p_proc_actual);
+	insertar_ultimo(lista, p_proc_actual);
+	p_proc_actual->lista_espera = lista;
 	fijar_nivel_int(nivel_previo);
 
-	/* Realizar cambio de contexto */
-	p_proc_anterior = p_proc_actual;
+	// siguiente proceso
 	p_proc_actual = planificador();
-
-	printk("-> C.CONTEXTO POR FIN: de %d a %d\n",
-		   p_proc_anterior->id, p_proc_actual->id);
-
-	liberar_pila(p_proc_anterior->pila);
-	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
-	return; /* no deber�a llegar aqui */
+	cambio_contexto(&proc_a_bloquear->contexto_regs, &p_proc_actual->contexto_regs);
 }
 
 /****************************************************************************************
- * Funciones relacionadas con el tratamiento de interrupciones
- *	excepciones: exc_arit exc_mem
- *	interrupciones de reloj: int_reloj
- *	interrupciones del terminal: int_terminal
- *	llamadas al sistemas: llam_sis
- *	interrupciones SW: int_sw
- *
+ * Funciones comunes a los objetos con nombre: comprobar_creacion, buscar_para_abrir
  */
 
-/*
- * Tratamiento de excepciones aritmeticas
- */
-static void exc_arit()
+// Rutina que comprueba si el proceso actual puede crear un objeto con el
+// nombre indicado en el indice dado. Devuelve 0 si puede, -1 si no
+static int comprobar_creacion(char *nombre, entrada_hash *indice, int tam)
 {
+	// si se pasa del tamaño maximo se devuelve un error
+	if (strlen(nombre) > MAX_NOM_MUT)
+	{
+		printk_error("ERROR: nombre %s demasiado largo.\n", nombre);
+		return -1;
+	}
 
-	if (!viene_de_modo_usuario())
-		panico("excepcion aritmetica cuando estaba dentro del kernel");
+	// miramos si al proceso actual le quedan descriptores libres
+	if (p_proc_actual->descs_libres == 0)
+	{
+		printk_error("ERROR: proceso actual no tiene descriptores libres.\n");
+		return -1;
+	}
 
-	printk("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+	if (buscar_hash(indice, tam, nombre) != -1)
+	{
+		printk_error("ERROR: nombre %s en uso.\n", nombre);
+		return -1;
+	}
+	return 0;
+}
 
-	return; /* no deber�a llegar aqui */
+// Rutina que busca el objeto de nombre dado para abrirlo desde el proceso
+// actual. Devuelve su posicion o -1 si no existe o no quedan descriptores
+static int buscar_para_abrir(char *nombre, entrada_hash *indice, int tam)
+{
+	int pos;
+
+	// miramos si al proceso actual le quedan descriptores libres
+	if (p_proc_actual->descs_libres == 0)
+	{
+		printk_error("ERROR: proceso actual no tiene descriptores libres.\n");
+		return -1;
+	}
+
+	pos = buscar_hash(indice, tam, nombre);
+	if (pos == -1)
+		printk_error("ERROR: no existe %s.\n", nombre);
+	return pos;
 }
 
+/****************************************************************************************
+ * Funciones relacionadas con la tabla de cerrojos de lectores/escritores:
+ * iniciar_tabla_rwlock, buscar_rwlock_libre, obtener_rwlock,
+ * despertar_rwlock, soltar_rwlock, cerrar_desc_rwlock
+ */
+
 /*
- * Tratamiento de excepciones en el acceso a memoria
+ * Funcion que inicia la tabla de cerrojos
  */
-static void exc_mem()
+static void iniciar_tabla_rwlock()
 {
-	// si hay una excepcion en modo sistema y no se estaba accediendo a un parametro de usuario
-	if (!viene_de_modo_usuario() && acceso_parametro == 0)
-		panico("excepcion de memoria cuando estaba dentro del kernel");
-
-	printk("-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
-	liberar_proceso();
+	int i;
 
-	return; /* no deber�a llegar aqui */
+	for (i = 0; i < NUM_RWLOCK; i++)
+		tabla_rwlock[i].estado = SIN_USAR;
+	iniciar_hash(hash_rwlock, TAM_HASH_RWLOCK);
 }
 
 /*
- * Tratamiento de interrupciones de terminal
+ * Funcion que busca una entrada libre en la tabla de cerrojos
  */
-static void int_terminal()
+static int buscar_rwlock_libre()
 {
-	char car;
+	int i;
 
-	car = leer_puerto(DIR_TERMINAL);
-	printk("-> TRATANDO INT. DE TERMINAL %c\n", car);
+	for (i = 0; i < NUM_RWLOCK; i++)
+		if (tabla_rwlock[i].estado == SIN_USAR)
+			return i;
+	return -1;
+}
 
-	// si el buffer esta completo se ignora el caracter nuevo
-	if (contCaracteres < TAM_BUF_TERM)
-	{
-		bufferTerminal[contCaracteres] = car;
-		contCaracteres++;
+// Rutina que dado un descriptor del proceso actual devuelve el cerrojo al que
+// se refiere, NULL si no esta abierto o no corresponde a un cerrojo
+rwlock *obtener_rwlock(unsigned int desc)
+{
+	int pos = obtener_objeto(desc, DESC_RWLOCK);
 
-		// desbloqueamos a un proceso si estaba bloqueado esperando caracteres que leer
-		desbloquear_proc_esperando(&lista_bloq_lectura);
-	}
-	return;
+	return pos == -1 ? NULL : &tabla_rwlock[pos];
 }
 
-/*
- * Tratamiento de interrupciones de reloj
- */
-static void int_reloj()
+// Funcion que despierta a los procesos que pueden coger el cerrojo en su
+// estado actual: un escritor si esta libre del todo, o bien todos los
+// lectores si no hay escritor (y, con preferencia de escritor, ninguno espera)
+void despertar_rwlock(rwlock *rw)
 {
-	num_ints += 1;
-	printk("-> TRATANDO INT. DE RELOJ\n");
+	if (rw->escritor != -1)
+		return;
 
-	// si hay al menos un proceso listo
-	if (lista_listos.primero != NULL)
+	if (rw->escritores_esperando.primero != NULL && rw->n_lectores == 0 &&
+		(rw->pref_escritor || rw->lectores_esperando.primero == NULL))
 	{
-		// contabilizamos si ha ocurrido en modo usuario o modo sistema
-		if (viene_de_modo_usuario())
-		{
-			p_proc_actual->int_usuario++;
-		}
-		else
-		{
-			p_proc_actual->int_sistema++;
-		}
-
-		// contabilizamos gasto de rodaja
-		p_proc_actual->ticks_rodaja_restantes--;
-		// si ha llegado al final de su rodaja se activa una interrupcion software
-		if (p_proc_actual->ticks_rodaja_restantes <= 0)
-		{
-			// guardamos referencia al proceso que queremos expulsar
-			proc_a_expulsar = p_proc_actual->id;
-			activar_int_SW();
-		}
+		// se le traspasa el cerrojo al despertarlo para que no se adelanten
+		// nuevos lectores mientras llega a ejecutar
+		rw->escritor = rw->escritores_esperando.primero->id;
+		desbloquear_proc_esperando(&rw->escritores_esperando);
 	}
+	else if (!rw->pref_escritor || rw->escritores_esperando.primero == NULL)
+		desbloquear_todos(&rw->lectores_esperando);
+}
 
-	// recorremos la lista de procesos bloqueados
-	BCP *proc_bloqueado = lista_bloq.primero;
-	BCP *aux_siguiente;
-	while (proc_bloqueado != NULL)
+// Funcion que suelta el cerrojo que tiene cogido el descriptor indicado
+void soltar_rwlock(rwlock *rw, descriptor *d)
+{
+	if (d->cogido == RW_LECTURA)
+		rw->n_lectores--;
+	else
+		rw->escritor = -1;
+	d->cogido = 0;
+
+	despertar_rwlock(rw);
+}
+
+// Funcion que cierra un descriptor de cerrojo del proceso actual, soltando
+// el cerrojo si lo tenia cogido
+void cerrar_desc_rwlock(int desc)
+{
+	rwlock *rw = obtener_rwlock(desc);
+
+	if (p_proc_actual->descs[desc].cogido)
+		soltar_rwlock(rw, &p_proc_actual->descs[desc]);
+
+	liberar_descriptor(desc);
+	rw->n_opens--;
+
+	// si no hay nadie con el cerrojo abierto se elimina definitivamente
+	if (rw->n_opens <= 0)
 	{
-		// quitamos un tick del contador
-		proc_bloqueado->ticks_bloq -= 1;
-		// si el proceso no tiene que seguir bloqueado más ticks
-		if (proc_bloqueado->ticks_bloq == 0)
-		{
-			proc_bloqueado->estado = LISTO;
-			// guardamos la referencia al siguiente antes de eliminar el actual de la lista
-			aux_siguiente = proc_bloqueado->siguiente;
-			// eliminamos al proceso de la lista de bloqueados
-			eliminar_elem(&lista_bloq, proc_bloqueado);
-			// lo añadimos a la lista de listos
-			insertar_ultimo(&lista_listos, proc_bloqueado);
-			// tomamos el siguiente proceso
-			proc_bloqueado = aux_siguiente;
-		}
-		else
-		{
-			// si no cogemos el siguiente
-			proc_bloqueado = proc_bloqueado->siguiente;
-		}
+		rw->estado = SIN_USAR;
+		eliminar_hash(hash_rwlock, TAM_HASH_RWLOCK, rw->nombre);
 	}
-
-	return;
 }
 
+/****************************************************************************************
+ * Funciones relacionadas con las tablas de semaforos y variables condicion:
+ * iniciar_tabla_sem, buscar_sem_libre, obtener_sem, cerrar_desc_sem,
+ * iniciar_tabla_cond, buscar_cond_libre, obtener_cond, cerrar_desc_cond
+ */
+
 /*
- * Tratamiento de llamadas al sistema
+ * Funcion que inicia la tabla de semaforos
  */
-static void tratar_llamsis()
+static void iniciar_tabla_sem()
 {
-	int nserv, res;
+	int i;
 
-	nserv = leer_registro(0);
-	if (nserv < NSERVICIOS)
-		res = (tabla_servicios[nserv].fservicio)();
-	else
-		res = -1; /* servicio no existente */
-	escribir_registro(0, res);
-	return;
+	for (i = 0; i < NUM_SEM; i++)
+		tabla_sem[i].estado = SIN_USAR;
+	iniciar_hash(hash_sem, TAM_HASH_SEM);
 }
 
 /*
- * Tratamiento de interrupciuones software
+ * Funcion que busca una entrada libre en la tabla de semaforos
  */
-static void int_sw()
+static int buscar_sem_libre()
 {
-	BCP *proc_expulsado;
-	int nivel_previo;
+	int i;
 
-	printk("-> TRATANDO INT. SW\n");
+	for (i = 0; i < NUM_SEM; i++)
+		if (tabla_sem[i].estado == SIN_USAR)
+			return i;
+	return -1;
+}
 
-	// comprobamos que el proceso a expulsar no ha terminado
-	if (p_proc_actual->id == proc_a_expulsar)
-	{
-		proc_expulsado = p_proc_actual;
-		nivel_previo = fijar_nivel_int(NIVEL_3);
-		// eliminamos al proceso de la lista de listos
-		eliminar_elem(&lista_listos, proc_expulsado);
-		// lo añadimos a la lista de listos
-		insertar_ultimo(&lista_listos, proc_expulsado);
-		fijar_nivel_int(nivel_previo);
+// Rutina que dado un descriptor del proceso actual devuelve el semaforo al
+// que se refiere, NULL si no esta abierto o no corresponde a un semaforo
+semaforo *obtener_sem(unsigned int desc)
+{
+	int pos = obtener_objeto(desc, DESC_SEMAFORO);
 
-		p_proc_actual = planificador();
-		cambio_contexto(&proc_expulsado->contexto_regs, &p_proc_actual->contexto_regs);
+	return pos == -1 ? NULL : &tabla_sem[pos];
+}
+
+// Funcion que cierra un descriptor de semaforo del proceso actual
+void cerrar_desc_sem(int desc)
+{
+	semaforo *sem = obtener_sem(desc);
+
+	liberar_descriptor(desc);
+	sem->n_opens--;
+
+	// si no hay nadie con el semaforo abierto se elimina definitivamente
+	if (sem->n_opens <= 0)
+	{
+		sem->estado = SIN_USAR;
+		eliminar_hash(hash_sem, TAM_HASH_SEM, sem->nombre);
 	}
+}
 
-	return;
+/*
+ * Funcion que inicia la tabla de variables condicion
+ */
+static void iniciar_tabla_cond()
+{
+	int i;
+
+	for (i = 0; i < NUM_COND; i++)
+		tabla_cond[i].estado = SIN_USAR;
+	iniciar_hash(hash_cond, TAM_HASH_COND);
 }
 
-/****************************************************************************************
- * Funcion auxiliar que crea un proceso reservando sus recursos.
- * Usada por llamada crear_proceso.
- *
+/*
+ * Funcion que busca una entrada libre en la tabla de variables condicion
  */
-static int crear_tarea(char *prog)
+static int buscar_cond_libre()
 {
-	void *imagen, *pc_inicial;
-	int error = 0;
-	int proc;
-	BCP *p_proc;
-	int nivel_previo;
 	int i;
 
-	proc = buscar_BCP_libre();
-	if (proc == -1)
-		return -1; /* no hay entrada libre */
+	for (i = 0; i < NUM_COND; i++)
+		if (tabla_cond[i].estado == SIN_USAR)
+			return i;
+	return -1;
+}
 
-	/* A rellenar el BCP ... */
-	p_proc = &(tabla_procs[proc]);
+// Rutina que dado un descriptor del proceso actual devuelve la variable
+// condicion a la que se refiere, NULL si no esta abierto o no lo es
+condicion *obtener_cond(unsigned int desc)
+{
+	int pos = obtener_objeto(desc, DESC_CONDICION);
 
-	/* crea la imagen de memoria leyendo ejecutable */
-	imagen = crear_imagen(prog, &pc_inicial);
-	if (imagen)
-	{
-		p_proc->info_mem = imagen;
-		p_proc->pila = crear_pila(TAM_PILA);
-		fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
-						   pc_inicial,
-						   &(p_proc->contexto_regs));
-		p_proc->id = proc;
-		p_proc->estado = LISTO;
-		p_proc->int_sistema = 0;
-		p_proc->int_usuario = 0;
+	return pos == -1 ? NULL : &tabla_cond[pos];
+}
+
+// Funcion que cierra un descriptor de variable condicion del proceso actual
+void cerrar_desc_cond(int desc)
+{
+	condicion *cond = obtener_cond(desc);
 
-		// iniciamos tabla de descriptores de mutex a -1
-		for (i = 0; i < NUM_MUT_PROC; i++)
-			p_proc->desc_mutex[i] = -1;
+	liberar_descriptor(desc);
+	cond->n_opens--;
 
-		/* lo inserta al final de cola de listos */
-		nivel_previo = fijar_nivel_int(NIVEL_3);
-		insertar_ultimo(&lista_listos, p_proc);
-		fijar_nivel_int(nivel_previo);
-		error = 0;
+	// si no hay nadie con la condicion abierta se elimina definitivamente
+	if (cond->n_opens <= 0)
+	{
+		cond->estado = SIN_USAR;
+		eliminar_hash(hash_cond, TAM_HASH_COND, cond->nombre);
 	}
-	else
-		error = -1; /* fallo al crear imagen */
-
-	return error;
 }
 
 /****************************************************************************************
- * Rutinas auxiliares para el tratamiento de caracteres en el buffer de terminal
+ * Funciones relacionadas con la tabla de barreras:
+ * iniciar_tabla_barrera, buscar_barrera_libre, obtener_barrera, cerrar_desc_barrera
  */
 
-int sacar_primer_caracter()
+/*
+ * Funcion que inicia la tabla de barreras
+ */
+static void iniciar_tabla_barrera()
 {
 	int i;
-	char c;
 
-	c = bufferTerminal[0];
-	// lo eliminamos del buffer
-	for (i = 0; i < contCaracteres - 1; i++)
+	for (i = 0; i < NUM_BARRERA; i++)
+		tabla_barrera[i].estado = SIN_USAR;
+	iniciar_hash(hash_barrera, TAM_HASH_BARRERA);
+}
+
+/*
+ * Funcion que busca una entrada libre en la tabla de barreras
+ */
+static int buscar_barrera_libre()
+{
+	int i;
+
+	for (i = 0; i < NUM_BARRERA; i++)
+		if (tabla_barrera[i].estado == SIN_USAR)
+			return i;
+	return -1;
+}
+
+// Rutina que dado un descriptor del proceso actual devuelve la barrera a la
+// que se refiere, NULL si no esta abierto o no corresponde a una barrera
+barrera *obtener_barrera(unsigned int desc)
+{
+	int pos = obtener_objeto(desc, DESC_BARRERA);
+
+	return pos == -1 ? NULL : &tabla_barrera[pos];
+}
+
+// Funcion que cierra un descriptor de barrera del proceso actual
+void cerrar_desc_barrera(int desc)
+{
+	barrera *bar = obtener_barrera(desc);
+
+	liberar_descriptor(desc);
+	bar->n_opens--;
+
+	// si no hay nadie con la barrera abierta se elimina definitivamente
+	if (bar->n_opens <= 0)
 	{
-		bufferTerminal[i] = bufferTerminal[i + 1];
+		bar->estado = SIN_USAR;
+		eliminar_hash(hash_barrera, TAM_HASH_BARRERA, bar->nombre);
 	}
+}
 
-	// restamos 1 al contadores de caracteres en bufffer
-	contCaracteres--;
+/****************************************************************************************
+ * Funciones relacionadas con la tabla de contadores:
+ * iniciar_tabla_contador, buscar_contador_libre, obtener_contador,
+ * despertar_contador, cerrar_desc_contador
+ */
 
-	// devolvemos caracter
-	return c;
+/*
+ * Funcion que inicia la tabla de contadores
+ */
+static void iniciar_tabla_contador()
+{
+	int i;
+
+	for (i = 0; i < NUM_CONTADOR; i++)
+		tabla_contador[i].estado = SIN_USAR;
+	iniciar_hash(hash_contador, TAM_HASH_CONTADOR);
+}
+
+/*
+ * Funcion que busca una entrada libre en la tabla de contadores
+ */
+static int buscar_contador_libre()
+{
+	int i;
+
+	for (i = 0; i < NUM_CONTADOR; i++)
+		if (tabla_contador[i].estado == SIN_USAR)
+			return i;
+	return -1;
+}
+
+// Rutina que dado un descriptor del proceso actual devuelve el contador al
+// que se refiere, NULL si no esta abierto o no corresponde a un contador
+contador *obtener_contador(unsigned int desc)
+{
+	int pos = obtener_objeto(desc, DESC_CONTADOR);
+
+	return pos == -1 ? NULL : &tabla_contador[pos];
+}
+
+// Funcion que despierta a los procesos que esperaban un valor que el
+// contador ya ha alcanzado. Los demas siguen esperando
+void despertar_contador(contador *cont)
+{
+	BCP *p, *sig;
+
+	for (p = cont->procesos_esperando.primero; p != NULL; p = sig)
+	{
+		sig = p->siguiente;
+		if (cont->valor >= p->objetivo_contador)
+			desbloquear_proceso(&cont->procesos_esperando, p);
+	}
+}
+
+// Funcion que cierra un descriptor de contador del proceso actual
+void cerrar_desc_contador(int desc)
+{
+	contador *cont = obtener_contador(desc);
+
+	liberar_descriptor(desc);
+	cont->n_opens--;
+
+	// si no hay nadie con el contador abierto se elimina definitivamente
+	if (cont->n_opens <= 0)
+	{
+		cont->estado = SIN_USAR;
+		eliminar_hash(hash_contador, TAM_HASH_CONTADOR, cont->nombre);
+	}
+}
+
+/*
+ * Funciones relacionadas con la tabla de tuberias:
+ * iniciar_tabla_tuberia, buscar_tuberia_libre, obtener_tuberia,
+ * abrir_extremo_tuberia, cerrar_desc_tuberia
+ */
+
+/*
+ * Funcion que inicia la tabla de tuberias
+ */
+static void iniciar_tabla_tuberia()
+{
+	int i;
+
+	for (i = 0; i < NUM_TUBERIA; i++)
+		tabla_tuberia[i].estado = SIN_USAR;
+	iniciar_hash(hash_tuberia, TAM_HASH_TUBERIA);
+}
+
+/*
+ * Funcion que busca una entrada libre en la tabla de tuberias
+ */
+static int buscar_tuberia_libre()
+{
+	int i;
+
+	for (i = 0; i < NUM_TUBERIA; i++)
+		if (tabla_tuberia[i].estado == SIN_USAR)
+			return i;
+	return -1;
+}
+
+// Rutina que dado un descriptor del proceso actual devuelve la tuberia a la
+// que se refiere, NULL si no esta abierto o no es un extremo del tipo pedido
+tuberia *obtener_tuberia(unsigned int desc, int tipo)
+{
+	int pos = obtener_objeto(desc, tipo);
+
+	return pos == -1 ? NULL : &tabla_tuberia[pos];
+}
+
+// Funcion que abre para el proceso actual el extremo indicado por modo, ya
+// validado, de la tuberia de la posicion pos. Devuelve el descriptor o -1 si
+// no quedan descriptores libres, sin contar entonces la apertura
+static int abrir_extremo_tuberia(int pos, int modo)
+{
+	tuberia *tub = &tabla_tuberia[pos];
+	int desc;
+
+	if (modo == TUB_LECTURA)
+	{
+		desc = reservar_descriptor(DESC_TUB_LECTURA, pos);
+		if (desc != -1)
+		{
+			tub->n_lectores++;
+			tub->hubo_lector = 1;
+		}
+		return desc;
+	}
+	desc = reservar_descriptor(DESC_TUB_ESCRITURA, pos);
+	if (desc != -1)
+	{
+		tub->n_escritores++;
+		tub->hubo_escritor = 1;
+	}
+	return desc;
+}
+
+// Funcion que cierra un descriptor de tuberia del proceso actual, sea del
+// extremo de lectura o del de escritura
+void cerrar_desc_tuberia(int desc)
+{
+	int tipo = p_proc_actual->descs[desc].tipo;
+	tuberia *tub = obtener_tuberia(desc, tipo);
+
+	liberar_descriptor(desc);
+	if (tipo == DESC_TUB_LECTURA)
+	{
+		// sin lectores los escritores bloqueados ya no pueden seguir
+		if (--tub->n_lectores == 0)
+			desbloquear_todos(&tub->escritores_esperando);
+	}
+	else if (--tub->n_escritores == 0)
+		// al cerrar el ultimo escritor los lectores reciben fin de fichero
+		desbloquear_todos(&tub->lectores_esperando);
+
+	// si no hay nadie con la tuberia abierta se elimina definitivamente,
+	// perdiendose los datos que no se hubieran leido
+	if (tub->n_lectores <= 0 && tub->n_escritores <= 0)
+	{
+		tub->estado = SIN_USAR;
+		eliminar_hash(hash_tuberia, TAM_HASH_TUBERIA, tub->nombre);
+	}
+}
+
+/*
+ * Funciones relacionadas con la tabla de memoria compartida:
+ * iniciar_tabla_memoria, buscar_memoria_libre, obtener_memoria,
+ * cerrar_desc_memoria
+ */
+
+/*
+ * Funcion que inicia la tabla de segmentos de memoria compartida
+ */
+static void iniciar_tabla_memoria()
+{
+	int i;
+
+	for (i = 0; i < NUM_MEMORIA; i++)
+		tabla_memoria[i].estado = SIN_USAR;
+	iniciar_hash(hash_memoria, TAM_HASH_MEMORIA);
+}
+
+/*
+ * Funcion que busca una entrada libre en la tabla de memoria compartida
+ */
+static int buscar_memoria_libre()
+{
+	int i;
+
+	for (i = 0; i < NUM_MEMORIA; i++)
+		if (tabla_memoria[i].estado == SIN_USAR)
+			return i;
+	return -1;
+}
+
+// Rutina que dado un descriptor del proceso actual devuelve el segmento al
+// que se refiere, NULL si no esta abierto o no corresponde a un segmento
+memoria *obtener_memoria(unsigned int desc)
+{
+	int pos = obtener_objeto(desc, DESC_MEMORIA);
+
+	return pos == -1 ? NULL : &tabla_memoria[pos];
+}
+
+// Funcion que desasocia al proceso actual del segmento de un descriptor
+void cerrar_desc_memoria(int desc)
+{
+	memoria *mem = obtener_memoria(desc);
+
+	liberar_descriptor(desc);
+	mem->n_opens--;
+
+	// al desasociarse el ultimo proceso se libera la zona. Si el segmento
+	// se habia destruido su nombre ya no esta en el indice
+	if (mem->n_opens <= 0)
+	{
+		if (!mem->destruido)
+			eliminar_hash(hash_memoria, TAM_HASH_MEMORIA, mem->nombre);
+		free(mem->dir);
+		mem->dir = NULL;
+		mem->estado = SIN_USAR;
+	}
+}
+
+/*
+ * Funciones relacionadas con la tabla de buzones:
+ * iniciar_tabla_buzon, buscar_buzon_libre, obtener_buzon,
+ * cerrar_desc_buzon
+ */
+
+/*
+ * Funcion que inicia la tabla de buzones
+ */
+static void iniciar_tabla_buzon()
+{
+	int i;
+
+	for (i = 0; i < NUM_BUZON; i++)
+		tabla_buzon[i].estado = SIN_USAR;
+	iniciar_hash(hash_buzon, TAM_HASH_BUZON);
+}
+
+/*
+ * Funcion que busca una entrada libre en la tabla de buzones
+ */
+static int buscar_buzon_libre()
+{
+	int i;
+
+	for (i = 0; i < NUM_BUZON; i++)
+		if (tabla_buzon[i].estado == SIN_USAR)
+			return i;
+	return -1;
+}
+
+// Rutina que dado un descriptor del proceso actual devuelve el buzon al
+// que se refiere, NULL si no esta abierto o no corresponde a un buzon
+buzon *obtener_buzon(unsigned int desc)
+{
+	int pos = obtener_objeto(desc, DESC_BUZON);
+
+	return pos == -1 ? NULL : &tabla_buzon[pos];
+}
+
+// Funcion que cierra un descriptor de buzon del proceso actual
+void cerrar_desc_buzon(int desc)
+{
+	buzon *buz = obtener_buzon(desc);
+
+	liberar_descriptor(desc);
+	buz->n_opens--;
+
+	// si no hay nadie con el buzon abierto se elimina definitivamente,
+	// perdiendose los mensajes que no se hubieran recibido
+	if (buz->n_opens <= 0)
+	{
+		buz->estado = SIN_USAR;
+		eliminar_hash(hash_buzon, TAM_HASH_BUZON, buz->nombre);
+	}
+}
+
+/*
+ * Funcion que cierra todos los descriptores del proceso actual, liberando
+ * los objetos que tuviera cogidos. Se llama al liberar un proceso
+ */
+static void liberar_descriptores()
+{
+	int desc;
+	unsigned int abiertos;
+
+	// se recorren solo los descriptores abiertos
+	abiertos = ~p_proc_actual->descs_libres & DESCS_TODOS_LIBRES;
+	for (; abiertos != 0; abiertos &= abiertos - 1)
+	{
+		desc = __builtin_ctz(abiertos);
+		switch (p_proc_actual->descs[desc].tipo)
+		{
+		case DESC_MUTEX:
+			cerrar_desc_mutex(desc);
+			break;
+		case DESC_RWLOCK:
+			cerrar_desc_rwlock(desc);
+			break;
+		case DESC_SEMAFORO:
+			cerrar_desc_sem(desc);
+			break;
+		case DESC_CONDICION:
+			cerrar_desc_cond(desc);
+			break;
+		case DESC_BARRERA:
+			cerrar_desc_barrera(desc);
+			break;
+		case DESC_CONTADOR:
+			cerrar_desc_contador(desc);
+			break;
+		case DESC_TUB_LECTURA:
+		case DESC_TUB_ESCRITURA:
+			cerrar_desc_tuberia(desc);
+			break;
+		case DESC_MEMORIA:
+			cerrar_desc_memoria(desc);
+			break;
+		case DESC_BUZON:
+			cerrar_desc_buzon(desc);
+			break;
+		}
+	}
+}
+
+/*
+ * Escribe lo que el proceso actual haya dejado en su buffer de salida de la
+ * biblioteca, que solo queda pendiente si no ha terminado normalmente
+ */
+static void vaciar_salida_usuario()
+{
+	salida_usuario *s = &pagina_usr.salida[p_proc_actual->id];
+
+	// detras de lo que ya hubiera escrito el proceso
+	vaciar_consola();
+	if (s->ocupados > 0 && s->ocupados <= TAM_BUF_SALIDA)
+		escribir_ker(s->datos, s->ocupados);
+	s->ocupados = 0;
 }
 
 /****************************************************************************************
- * Rutinas que llevan a cabo las llamadas al sistema
- *	sis_crear_proceso sis_escribir
+ * Funcion auxiliar que termina proceso actual liberando sus recursos.
+ * Usada por llamada terminar_proceso y por rutinas que tratan excepciones
+ *
+ */
+static void liberar_proceso()
+{
+	BCP *p_proc_anterior;
+	int nivel_previo;
+
+	liberar_descriptores();					 // liberamos mutex y demas objetos
+	vaciar_salida_usuario();				 // si muere con salida pendiente
+	liberar_imagen(p_proc_actual->info_mem); /* liberar mapa */
+
+	p_proc_actual->estado = TERMINADO;
+	nivel_previo = fijar_nivel_int(NIVEL_3);
+	eliminar_primero(&lista_listos); /* proc. fuera de listos */
+	fijar_nivel_int(nivel_previo);
+
+	/* Realizar cambio de contexto */
+	p_proc_anterior = p_proc_actual;
+	p_proc_actual = planificador();
+
+	printk_traza("-> C.CONTEXTO POR FIN: de %d a %d\n",
+				 p_proc_anterior->id, p_proc_actual->id);
+
+	liberar_pila(p_proc_anterior->pila);
+	cambio_contexto(NULL, &(p_proc_actual->contexto_regs));
+	return; /* no deber�a llegar aqui */
+}
+
+/****************************************************************************************
+ * Funciones relacionadas con el tratamiento de interrupciones
+ *	excepciones: exc_arit exc_mem
+ *	interrupciones de reloj: int_reloj
+ *	interrupciones del terminal: int_terminal
+ *	llamadas al sistemas: llam_sis
+ *	interrupciones SW: int_sw
  *
  */
 
-/*
- * Tratamiento de llamada al sistema crear_proceso. Llama a la
- * funcion auxiliar crear_tarea sis_terminar_proceso
- */
-int sis_crear_proceso()
+/*
+ * Tratamiento de excepciones aritmeticas
+ */
+static void exc_arit()
+{
+
+	if (!viene_de_modo_usuario())
+		panico("excepcion aritmetica cuando estaba dentro del kernel");
+
+	printk_aviso("-> EXCEPCION ARITMETICA EN PROC %d\n", p_proc_actual->id);
+	liberar_proceso();
+
+	return; /* no deber�a llegar aqui */
+}
+
+/*
+ * Tratamiento de excepciones en el acceso a memoria
+ */
+static void exc_mem()
+{
+	// si hay una excepcion en modo sistema y no se estaba accediendo a un parametro de usuario
+	if (!viene_de_modo_usuario() && acceso_parametro == 0)
+		panico("excepcion de memoria cuando estaba dentro del kernel");
+
+	printk_aviso("-> EXCEPCION DE MEMORIA EN PROC %d\n", p_proc_actual->id);
+	liberar_proceso();
+
+	return; /* no deber�a llegar aqui */
+}
+
+/*
+ * Tratamiento de interrupciones de terminal
+ */
+static void int_terminal()
+{
+	char car;
+
+	car = leer_puerto(DIR_TERMINAL);
+	printk_traza("-> TRATANDO INT. DE TERMINAL %c\n", car);
+	anotar_traza(TRAZA_INT_TERMINAL, p_proc_actual != NULL ? p_proc_actual->id : -1, car);
+
+	estad_term.recibidos++;
+	if (modoTerminal == TERM_LINEA)
+	{
+		// el borrado quita el ultimo caracter de la linea en curso, si lo hay
+		if (car == '\b' || car == 127)
+		{
+			if (contCaracteres > contDisponibles)
+				contCaracteres--;
+			return;
+		}
+		if (car == '\r')
+			car = '\n';
+	}
+
+	// si el buffer esta completo se descarta el caracter nuevo
+	if (contCaracteres < TAM_BUF_TERM)
+	{
+		bufferTerminal[(primerCaracter + contCaracteres) % TAM_BUF_TERM] = car;
+		contCaracteres++;
+	}
+	else
+		estad_term.perdidos++;
+
+	// en modo linea los caracteres no se pueden leer hasta que se completa
+	// la linea, o hasta que se llena el buffer para no quedarse sin sitio
+	if (modoTerminal == TERM_CARACTER || car == '\n' || contCaracteres == TAM_BUF_TERM)
+	{
+		if (contDisponibles < contCaracteres)
+		{
+			contDisponibles = contCaracteres;
+			// desbloqueamos a un proceso si estaba bloqueado esperando caracteres que leer
+			desbloquear_proc_esperando(&lista_bloq_lectura);
+			despertar_eventos(1, NULL);
+		}
+	}
+	return;
+}
+
+/*
+ * Tratamiento de interrupciones de reloj
+ */
+static void int_reloj()
+{
+	int i;
+	BCP *p;
+
+	num_ints += 1;
+	pagina_usr.ticks = num_ints;
+	printk_traza("-> TRATANDO INT. DE RELOJ\n");
+	anotar_traza(TRAZA_INT_RELOJ, lista_listos.primero != NULL ? p_proc_actual->id : -1, 0);
+
+	// si hay al menos un proceso listo
+	if (lista_listos.primero != NULL)
+	{
+		// contabilizamos si ha ocurrido en modo usuario o modo sistema
+		if (viene_de_modo_usuario())
+		{
+			p_proc_actual->int_usuario++;
+		}
+		else
+		{
+			p_proc_actual->int_sistema++;
+		}
+
+		// contabilizamos gasto de rodaja
+		p_proc_actual->ticks_rodaja_restantes--;
+		// si ha llegado al final de su rodaja se activa una interrupcion software
+		if (p_proc_actual->ticks_rodaja_restantes <= 0)
+		{
+			// guardamos referencia al proceso que queremos expulsar
+			proc_a_expulsar = p_proc_actual->id;
+			activar_int_SW();
+		}
+	}
+
+	// la salida pendiente no se escribe aqui sino en la int. software, que
+	// no inhibe el reloj mientras escribe. Los que esperan sitio en la cola
+	// se despiertan y vuelven a mirar si les cabe el texto
+	if (contConsola > 0)
+		activar_int_SW();
+	if (lista_bloq_escritura.primero != NULL)
+		desbloquear_todos(&lista_bloq_escritura);
+
+	// recorremos la lista de procesos bloqueados
+	BCP *proc_bloqueado = lista_bloq.primero;
+	BCP *aux_siguiente;
+	while (proc_bloqueado != NULL)
+	{
+		// quitamos un tick del contador
+		proc_bloqueado->ticks_bloq -= 1;
+		// si el proceso no tiene que seguir bloqueado más ticks
+		if (proc_bloqueado->ticks_bloq == 0)
+		{
+			proc_bloqueado->estado = LISTO;
+			anotar_traza(TRAZA_DESPERTAR, proc_bloqueado->id, 0);
+			// guardamos la referencia al siguiente antes de eliminar el actual de la lista
+			aux_siguiente = proc_bloqueado->siguiente;
+			// eliminamos al proceso de la lista de bloqueados
+			eliminar_elem(&lista_bloq, proc_bloqueado);
+			// lo añadimos a la lista de listos
+			insertar_ultimo(&lista_listos, proc_bloqueado);
+			// tomamos el siguiente proceso
+			proc_bloqueado = aux_siguiente;
+		}
+		else
+		{
+			// si no cogemos el siguiente
+			proc_bloqueado = proc_bloqueado->siguiente;
+		}
+	}
+
+	// vencen los plazos de los procesos bloqueados con una espera limitada,
+	// que vuelven a listos fuera de la lista en la que esperaban
+	for (i = 0; i < MAX_PROC; i++)
+	{
+		p = &tabla_procs[i];
+		if (p->estado == BLOQUEADO && p->ticks_plazo > 0 && --p->ticks_plazo == 0)
+		{
+			p->plazo_vencido = 1;
+			p->estado = LISTO;
+			anotar_traza(TRAZA_DESPERTAR, p->id, 0);
+			eliminar_elem(p->lista_espera, p);
+			insertar_ultimo(&lista_listos, p);
+		}
+	}
+
+	return;
+}
+
+/*
+ * Tratamiento de llamadas al sistema
+ */
+static void tratar_llamsis()
+{
+	int nserv, res;
+
+	nserv = leer_registro(0);
+	anotar_traza(TRAZA_LLAMADA, p_proc_actual->id, nserv);
+	if (nserv < NSERVICIOS)
+		res = (tabla_servicios[nserv].fservicio)();
+	else
+		res = -1; /* servicio no existente */
+	anotar_traza(TRAZA_FIN_LLAMADA, p_proc_actual->id, nserv);
+	escribir_registro(0, res);
+	return;
+}
+
+/*
+ * Tratamiento de interrupciuones software
+ */
+static void int_sw()
+{
+	BCP *proc_expulsado;
+	int nivel_previo;
+
+	printk_traza("-> TRATANDO INT. SW\n");
+	anotar_traza(TRAZA_INT_SW, p_proc_actual->id, 0);
+
+	// escribimos la salida que el reloj ha dejado pendiente
+	vaciar_consola();
+
+	// comprobamos que el proceso a expulsar no ha terminado
+	if (p_proc_actual->id == proc_a_expulsar)
+	{
+		proc_expulsado = p_proc_actual;
+		// la int. software tambien se activa para vaciar la consola, y no
+		// debe volver a expulsar a este proceso por la misma rodaja
+		proc_a_expulsar = -1;
+		nivel_previo = fijar_nivel_int(NIVEL_3);
+		// eliminamos al proceso de la lista de listos
+		eliminar_elem(&lista_listos, proc_expulsado);
+		// lo añadimos a la lista de listos
+		insertar_ultimo(&lista_listos, proc_expulsado);
+		fijar_nivel_int(nivel_previo);
+
+		p_proc_actual = planificador();
+		cambio_contexto(&proc_expulsado->contexto_regs, &p_proc_actual->contexto_regs);
+	}
+
+	return;
+}
+
+/****************************************************************************************
+ * Funcion auxiliar que crea un proceso reservando sus recursos.
+ * Usada por llamada crear_proceso.
+ *
+ */
+static int crear_tarea(char *prog)
+{
+	void *imagen, *pc_inicial;
+	int error = 0;
+	int proc;
+	BCP *p_proc;
+	int nivel_previo;
+
+	proc = buscar_BCP_libre();
+	if (proc == -1)
+		return -1; /* no hay entrada libre */
+
+	/* A rellenar el BCP ... */
+	p_proc = &(tabla_procs[proc]);
+
+	/* crea la imagen de memoria leyendo ejecutable */
+	imagen = crear_imagen(prog, &pc_inicial);
+	if (imagen)
+	{
+		p_proc->info_mem = imagen;
+		p_proc->pila = crear_pila(TAM_PILA);
+		fijar_contexto_ini(p_proc->info_mem, p_proc->pila, TAM_PILA,
+						   pc_inicial,
+						   &(p_proc->contexto_regs));
+		p_proc->id = proc;
+		p_proc->estado = LISTO;
+		p_proc->int_sistema = 0;
+		p_proc->int_usuario = 0;
+		p_proc->prioridad_base = PRIORIDAD_DEFECTO;
+		p_proc->prioridad = PRIORIDAD_DEFECTO;
+		p_proc->mutex_esperado = NULL;
+		p_proc->ticks_plazo = 0;
+
+		// la salida de la biblioteca empieza vacia y en modo linea
+		pagina_usr.salida[proc].modo = 0;
+		pagina_usr.salida[proc].ocupados = 0;
+
+		// todos los descriptores del proceso empiezan libres
+		p_proc->descs_libres = DESCS_TODOS_LIBRES;
+
+		/* lo inserta al final de cola de listos */
+		nivel_previo = fijar_nivel_int(NIVEL_3);
+		insertar_ultimo(&lista_listos, p_proc);
+		fijar_nivel_int(nivel_previo);
+		error = 0;
+	}
+	else
+		error = -1; /* fallo al crear imagen */
+
+	return error;
+}
+
+/****************************************************************************************
+ * Rutinas auxiliares para el tratamiento de caracteres en el buffer de terminal
+ */
+
+int sacar_primer_caracter()
+{
+	char c;
+
+	c = bufferTerminal[primerCaracter];
+	// lo eliminamos del buffer avanzando el principio
+	primerCaracter = (primerCaracter + 1) % TAM_BUF_TERM;
+
+	// restamos 1 al contadores de caracteres en bufffer
+	contCaracteres--;
+	contDisponibles--;
+	estad_term.consumidos++;
+
+	// devolvemos caracter
+	return c;
+}
+
+/****************************************************************************************
+ * Rutinas que llevan a cabo las llamadas al sistema
+ *	sis_crear_proceso sis_escribir
+ *
+ */
+
+/*
+ * Tratamiento de llamada al sistema crear_proceso. Llama a la
+ * funcion auxiliar crear_tarea sis_terminar_proceso
+ */
+int sis_crear_proceso()
+{
+	char *prog;
+	int res;
+
+	printk_info("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
+	prog = (char *)leer_registro(1);
+	res = crear_tarea(prog);
+	return res;
+}
+
+/*
+ * Deja el texto en la cola de salida por consola, que se escribe despues,
+ * y solo se bloquea si no cabe. Un texto que quepa en la cola se encola
+ * entero de una vez; uno mayor, por trozos en orden
+ */
+int sis_escribir()
+{
+	char *texto;
+	unsigned int longi, n, libre, hasta_final;
+	int fin, nivel_previo;
+
+	texto = (char *)leer_registro(1);
+	longi = (unsigned int)leer_registro(2);
+
+	while (longi > 0)
+	{
+		n = longi < TAM_COLA_CONSOLA ? longi : TAM_COLA_CONSOLA;
+
+		// la cola se puede vaciar en cualquier momento, asi que el hueco se
+		// mira inhibiendo interrupciones pero se espera con ellas permitidas.
+		// Al despertar se vuelve a mirar, ya que el reloj despierta a todos
+		for (;;)
+		{
+			nivel_previo = fijar_nivel_int(NIVEL_3);
+			libre = TAM_COLA_CONSOLA - contConsola;
+			fin = (primeroConsola + contConsola) % TAM_COLA_CONSOLA;
+			fijar_nivel_int(nivel_previo);
+			if (libre >= n)
+				break;
+			bloquear_proceso_actual(&lista_bloq_escritura);
+		}
+
+		// el hueco libre solo puede crecer mientras se copia en el
+		hasta_final = TAM_COLA_CONSOLA - fin;
+
+		// controlamos acceso por si hay excepción
+		acceso_parametro = 1;
+		if (n <= hasta_final)
+			memcpy(&colaConsola[fin], texto, n);
+		else
+		{
+			memcpy(&colaConsola[fin], texto, hasta_final);
+			memcpy(colaConsola, texto + hasta_final, n - hasta_final);
+		}
+		acceso_parametro = 0;
+
+		nivel_previo = fijar_nivel_int(NIVEL_3);
+		contConsola += n;
+		fijar_nivel_int(nivel_previo);
+
+		texto += n;
+		longi -= n;
+	}
+	return 0;
+}
+
+/*
+ * Tratamiento de llamada al sistema terminar_proceso. Llama a la
+ * funcion auxiliar liberar_proceso
+ */
+int sis_terminar_proceso()
+{
+	// lo que haya escrito el proceso sale antes que su fin
+	vaciar_consola();
+
+	printk_info("-> FIN PROCESO %d\n", p_proc_actual->id);
+
+	liberar_proceso();
+
+	return 0; /* no deber�a llegar aqui */
+}
+
+/* Rutina que devuelve el ID del proceso */
+int sis_obtener_id_pr()
+{
+	return p_proc_actual->id;
+}
+
+/* Rutina que duerme al proceso actual n segundos */
+int sis_dormir()
+{
+	unsigned int segundos;
+	int nivel_previo;
+	BCP *proc_a_dormir;
+	segundos = (unsigned int)leer_registro(1);
+
+	// indicamos ticks iniciales de bloqueo
+	p_proc_actual->ticks_bloq = (segundos * TICK);
+	p_proc_actual->estado = BLOQUEADO;
+	proc_a_dormir = p_proc_actual;
+
+	// inhabilitamos todas las interrupciones
+	nivel_previo = fijar_nivel_int(NIVEL_3);
+
+	// sacamos el proceso actual de la lista de listos
+	eliminar_elem(&lista_listos, p_proc_actual);
+
+	// insertamos proceso bloqueado en la lista pertinente
+	insertar_ultimo(&lista_bloq, p_proc_actual);
+
+	// volvemos al nivel anterior
+	fijar_nivel_int(nivel_previo);
+
+	// siguiente proceso
+	p_proc_actual = planificador();
+	cambio_contexto(&proc_a_dormir->contexto_regs, &p_proc_actual->contexto_regs);
+	return 0;
+}
+
+/* Rutina que  contabiliza el uso del procesador por parte de un proceso */
+int sis_tiempos_proceso()
+{
+	struct tiempos_ejec_t *tiempos;
+	int nivel_previo;
+	tiempos = (struct tiempos_ejec_t *)leer_registro(1);
+
+	if (tiempos != NULL)
+	{
+		// inhabilitamos todas las interrupciones
+		nivel_previo = fijar_nivel_int(NIVEL_3);
+		// controlamos acceso por si hay excepción
+		acceso_parametro = 1;
+
+		tiempos->sistema = p_proc_actual->int_sistema;
+		tiempos->usuario = p_proc_actual->int_usuario;
+
+		acceso_parametro = 0;
+		// volvemos al nivel anterior
+		fijar_nivel_int(nivel_previo);
+	}
+
+	return num_ints;
+}
+
+/* Rutinas mutex */
+
+int sis_crear_mutex()
+{
+	char *nombre;
+	int tipo, pos, nivel_previo, se_ha_bloqueado = 0;
+	BCP *proc_a_bloquear;
+	mutex *mut;
+
+	nombre = (char *)leer_registro(1);
+	tipo = (int)leer_registro(2);
+
+	// si se pasa del tamaño maximo se devuelve un error
+	if (strlen(nombre) > MAX_NOM_MUT)
+	{
+		printk_error("ERROR: nombre de mutex demaisado largo.\n");
+		return -1;
+	}
+
+	// miramos si al proceso actual le quedan descriptores libres
+	if (p_proc_actual->descs_libres == 0)
+	{
+		printk_error("ERROR: proceso actual no tiene descriptores de mutex libres.\n");
+		return -1;
+	}
+
+	// si ya existe ese nombre en la tabla de mutex devuelve error
+	pos = buscar_nombre_mutex(nombre);
+	if (pos != -1)
+	{
+		printk_error("ERROR: nombre de Mutex %s en uso.\n", nombre);
+		return -1;
+	}
+
+	// si se ha alcanzado el numero maximo de mutex se bloquea hasta que se
+	// puedan crear mas, salvo que se pida fallar en ese caso
+	while (!hay_mutex_libre())
+	{
+		if (tipo & MUTEX_SIN_ESPERA)
+		{
+			printk_error("ERROR: no se pueden hacer mas mutex.\n");
+			return -1;
+		}
+		se_ha_bloqueado = 1;
+		printk_aviso("WARNING: proceso actual bloqueado, no se pueden hacer mas mutex.\n");
+		nivel_previo = fijar_nivel_int(3);
+
+		p_proc_actual->estado = BLOQUEADO;
+		proc_a_bloquear = p_proc_actual;
+		// sacamos el proceso actual de la lista de listos
+		eliminar_elem(&lista_listos, p_proc_actual);
+
+		// insertamos proceso bloqueado en la lista pertinente
+		insertar_ultimo(&lista_bloq_mutex, p_proc_actual);
+
+		fijar_nivel_int(nivel_previo);
+
+		// siguiente proceso
+		p_proc_actual = planificador();
+		cambio_contexto(&proc_a_bloquear->contexto_regs, &p_proc_actual->contexto_regs);
+	}
+
+	// si se ha bloqueado, hay que volver a comprobar si durante ese tiempo alguien ha creado un mutex con el mismo nombre
+	if (se_ha_bloqueado)
+	{
+		pos = buscar_nombre_mutex(nombre);
+		if (pos != -1)
+		{
+			printk_error("ERROR: nombre de Mutex en uso.\n");
+			return -1;
+		}
+	}
+
+	// se crea por fin el mutex en una posicion libre
+	pos = tomar_mutex_libre();
+	mut = MUTEX_POS(pos);
+	strcpy(mut->nombre, nombre);
+	mut->estado = EN_USO;
+	mut->compartido.tipo = tipo & ~(MUTEX_TRASPASO | MUTEX_SIN_ESPERA);
+	mut->traspaso = (tipo & MUTEX_TRASPASO) != 0;
+	mut->compartido.palabra = 0;
+	mut->compartido.n_blocks = 0;
+	memset(&mut->compartido.estad, 0, sizeof(estad_mutex));
+	mut->procesos_esperando.primero = NULL;
+	mut->procesos_esperando.ultimo = NULL;
+	mut->n_opens = 1;
+	insertar_hash(hash_mutex, TAM_HASH_MUT, mut->nombre, pos);
+	n_mutex_open++;
+
+	// le asignamos la posicion de la tabla a un descriptor libre del proceso actual
+	return reservar_descriptor_mutex(pos);
+}
+
+int sis_abrir_mutex()
+{
+	int mutexid;
+	char *nombre;
+
+	// miramos si al proceso actual le quedan descriptores libres
+	if (p_proc_actual->descs_libres == 0)
+	{
+		printk_error("ERROR: proceso actual no tiene descriptores de mutex libres.\n");
+		return -1;
+	}
+
+	nombre = (char *)leer_registro(1);
+	mutexid = buscar_nombre_mutex(nombre);
+	if (mutexid == -1)
+	{
+		printk_error("ERROR: no existe mutex con ese nombre.\n");
+		return -1;
+	}
+
+	// se asocia un descriptor del proceso al mutex correspondiente
+	MUTEX_POS(mutexid)->n_opens++;
+
+	return reservar_descriptor_mutex(mutexid);
+}
+
+// Funcion que bloquea al proceso actual en la lista de espera de un mutex que
+// tiene otro proceso, el cual hereda su prioridad mientras tanto
+static void esperar_mutex(mutex *mut)
+{
+	int nivel_previo, n;
+	BCP *proc_a_bloquear, *p;
+
+	// asi el propietario entrara al kernel para despertarnos al liberarlo
+	mut->compartido.palabra |= MUTEX_ESPERANDO;
+
+	nivel_previo = fijar_nivel_int(3);
+
+	p_proc_actual->estado = BLOQUEADO;
+	proc_a_bloquear = p_proc_actual;
+	// sacamos el proceso actual de la lista de listos
+	eliminar_elem(&lista_listos, p_proc_actual);
+
+	// insertamos proceso bloqueado en la lista de procesos esperando al mutex
+	insertar_ultimo(&mut->procesos_esperando, p_proc_actual);
+	p_proc_actual->lista_espera = &mut->procesos_esperando;
+
+	// se recorre la lista antes de que el reloj pueda sacar a alguien
+	for (n = 0, p = mut->procesos_esperando.primero; p != NULL; p = p->siguiente)
+		n++;
+	if (n > mut->compartido.estad.max_esperando)
+		mut->compartido.estad.max_esperando = n;
+
+	fijar_nivel_int(nivel_previo);
+
+	// el propietario hereda nuestra prioridad si es mayor que la suya
+	p_proc_actual->mutex_esperado = mut;
+	recalcular_prioridad(&tabla_procs[PROPIETARIO_MUTEX(mut)]);
+
+	// siguiente proceso
+	p_proc_actual = planificador();
+	cambio_contexto(&proc_a_bloquear->contexto_regs, &p_proc_actual->contexto_regs);
+}
+
+// Funcion que bloquea el mutex para el proceso actual, que no es su
+// propietario, esperando si hace falta a que quede libre. plazo son los ticks
+// que se puede esperar como mucho, 0 para no esperar o ESPERA_INDEFINIDA.
+// Devuelve 0 si lo consigue y -1 si no
+static int coger_mutex(mutex *mut, int plazo)
+{
+	int propietario, esperado = 0;
+
+	// el plazo es para toda la espera, aunque haya que bloquearse varias veces
+	p_proc_actual->ticks_plazo = plazo > 0 ? plazo : 0;
+	p_proc_actual->plazo_vencido = 0;
+	p_proc_actual->inicio_espera = num_ints;
+
+	// miramos si esta libre el mutex. Si lo estaba la biblioteca ya lo habra
+	// cogido sin llamar al sistema, pero puede haber quedado libre despues
+	while (mut->compartido.palabra != 0)
+	{
+		if (plazo == 0)
+			return -1;
+
+		esperar_mutex(mut);
+		esperado = 1;
+
+		// en modo traspaso nos despiertan ya como propietarios. Se mira
+		// antes que el plazo para no devolver error teniendo el mutex
+		if (PROPIETARIO_MUTEX(mut) == p_proc_actual->id)
+		{
+			p_proc_actual->ticks_plazo = 0;
+			return 0;
+		}
+
+		// si ha vencido el plazo el propietario deja de heredar de nosotros
+		if (p_proc_actual->plazo_vencido)
+		{
+			p_proc_actual->mutex_esperado = NULL;
+			propietario = PROPIETARIO_MUTEX(mut);
+			if (propietario >= 0)
+				recalcular_prioridad(&tabla_procs[propietario]);
+			return -1;
+		}
+	}
+	p_proc_actual->ticks_plazo = 0;
+
+	// cuando este libre lo bloquea, conservando la marca si quedan procesos esperando
+	mut->compartido.palabra = (p_proc_actual->id + 1) |
+							  (mut->procesos_esperando.primero ? MUTEX_ESPERANDO : 0);
+	mut->compartido.n_blocks = 1;
+	anotar_adquisicion(mut, p_proc_actual, esperado);
+	return 0;
+}
+
+// Funcion comun a lock, trylock y lock_timeout con el plazo de espera que
+// admite cada una
+static int lock_con_plazo(unsigned int mutexid, int plazo)
+{
+	mutex *mut;
+
+	// primero mira si el proceso ha abierto el mutex y obtiene su información
+	mut = obtener_mutex(mutexid);
+	if (mut == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el mutex %d.\n", mutexid);
+		return -1;
+	}
+
+	// miramos si el proceso actual ya es propietario del mutex
+	if (PROPIETARIO_MUTEX(mut) == p_proc_actual->id)
+	{
+		// comprobamos qua tipo de mutex es
+		if (mut->compartido.tipo == RECURSIVO)
+		{
+			mut->compartido.n_blocks++; // proceso vuelve a bloquear el mutex
+			return 0;
+		}
+		printk_error("ERROR: el proceso ya es propietario del mutex no recursivo %d.\n", mutexid);
+		return -1;
+	}
+
+	// si no es propietario y no lo puede coger se bloquea el proceso
+	return coger_mutex(mut, plazo);
+}
+
+int sis_lock()
+{
+	return lock_con_plazo((unsigned int)leer_registro(1), ESPERA_INDEFINIDA);
+}
+
+int sis_trylock()
+{
+	return lock_con_plazo((unsigned int)leer_registro(1), 0);
+}
+
+int sis_lock_timeout()
+{
+	unsigned int mutexid;
+	int ticks;
+
+	mutexid = (unsigned int)leer_registro(1);
+	ticks = (int)leer_registro(2);
+	return lock_con_plazo(mutexid, ticks > 0 ? ticks : 0);
+}
+
+// Rutina que lee de la zona de usuario un vector de n descriptores
+// Devuelve 0 si es correcto y -1 si n no es valido
+static int leer_vector_descs(unsigned int *ids_usr, int n, unsigned int *ids)
+{
+	int i;
+
+	if (n <= 0 || n > NUM_DESC_PROC)
+	{
+		printk_error("ERROR: numero de descriptores %d no valido.\n", n);
+		return -1;
+	}
+
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	for (i = 0; i < n; i++)
+		ids[i] = ids_usr[i];
+	acceso_parametro = 0;
+	return 0;
+}
+
+/*
+ * Bloquea todos los mutex indicados de una vez. Mientras alguno lo tenga
+ * otro proceso se espera por el sin retener ninguno de los demas, de modo
+ * que no hay interbloqueos por el orden en que se piden
+ */
+int sis_lock_varios()
+{
+	unsigned int ids[NUM_DESC_PROC];
+	mutex *muts[NUM_DESC_PROC], *ocupado;
+	unsigned int propios = 0; // los del conjunto que ya eran del proceso
+	int n, i, j, yo, esperado = 0;
+
+	n = (int)leer_registro(2);
+	if (leer_vector_descs((unsigned int *)leer_registro(1), n, ids) < 0)
+		return -1;
+
+	yo = p_proc_actual->id;
+	for (i = 0; i < n; i++)
+	{
+		muts[i] = obtener_mutex(ids[i]);
+		if (muts[i] == NULL)
+		{
+			printk_error("ERROR: el proceso no ha abierto el mutex %d.\n", ids[i]);
+			return -1;
+		}
+		for (j = 0; j < i; j++)
+			if (muts[j] == muts[i])
+			{
+				printk_error("ERROR: mutex %d repetido.\n", ids[i]);
+				return -1;
+			}
+		if (PROPIETARIO_MUTEX(muts[i]) == yo)
+		{
+			if (muts[i]->compartido.tipo != RECURSIVO)
+			{
+				printk_error("ERROR: el proceso ya es propietario del mutex no recursivo %d.\n", ids[i]);
+				return -1;
+			}
+			propios |= 1u << i;
+		}
+	}
+
+	p_proc_actual->ticks_plazo = 0;
+	p_proc_actual->inicio_espera = num_ints;
+	for (;;)
+	{
+		ocupado = NULL;
+		for (i = 0; i < n && ocupado == NULL; i++)
+			if (muts[i]->compartido.palabra != 0 && PROPIETARIO_MUTEX(muts[i]) != yo)
+				ocupado = muts[i];
+		if (ocupado == NULL)
+			break;
+
+		// en modo traspaso nos pueden haber cedido alguno mientras esperabamos
+		// por otro: se devuelve para no retenerlo durante la espera
+		for (i = 0; i < n; i++)
+			if (!(propios & (1u << i)) && PROPIETARIO_MUTEX(muts[i]) == yo)
+				soltar_mutex(muts[i]);
+
+		esperar_mutex(ocupado);
+		esperado = 1;
+	}
+
+	// estan todos libres o ya son nuestros: se cogen sin volver a bloquearse
+	for (i = 0; i < n; i++)
+	{
+		if (propios & (1u << i))
+			muts[i]->compartido.n_blocks++;
+		else if (PROPIETARIO_MUTEX(muts[i]) != yo)
+		{
+			muts[i]->compartido.palabra = (yo + 1) |
+				(muts[i]->procesos_esperando.primero ? MUTEX_ESPERANDO : 0);
+			muts[i]->compartido.n_blocks = 1;
+			anotar_adquisicion(muts[i], p_proc_actual, esperado);
+		}
+	}
+	return 0;
+}
+
+// Funcion que hace un unlock del mutex indicado por el proceso actual
+static int unlock_mutex(unsigned int mutexid)
+{
+	mutex *mut;
+
+	// primero mira si el proceso ha abierto el mutex y obtiene su información
+	mut = obtener_mutex(mutexid);
+	if (mut == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el mutex %d.\n", mutexid);
+		return -1;
+	}
+
+	// comprueba que el mutex esta bloqueado
+	if (mut->compartido.palabra == 0)
+	{
+		printk_error("ERROR: el mutex %d no esta bloqueado.\n", mutexid);
+		return -1;
+	}
+
+	// comprueba que el proceso actual tiene bloqueado el mutex
+	if (PROPIETARIO_MUTEX(mut) != p_proc_actual->id)
+	{
+		printk_error("ERROR: el mutex %d no esta bloqueado por el proceso actual.\n", mutexid);
+		return -1;
+	}
+
+	// restamos 1 al contador de bloqueos
+	mut->compartido.n_blocks--;
+
+	// si el proceso actual ha hecho el mismo nº de locks que unlocks se libera
+	// y desbloqueamos al primer proceso esperando por el mutex si lo hay
+	if (mut->compartido.n_blocks <= 0)
+		soltar_mutex(mut);
+
+	return 0;
+}
+
+int sis_unlock()
+{
+	return unlock_mutex((unsigned int)leer_registro(1));
+}
+
+/* Desbloquea varios mutex en una sola llamada. Si alguno da error se
+   siguen desbloqueando los demas y se devuelve -1 */
+int sis_unlock_varios()
+{
+	unsigned int ids[NUM_DESC_PROC];
+	int n, i, res = 0;
+
+	n = (int)leer_registro(2);
+	if (leer_vector_descs((unsigned int *)leer_registro(1), n, ids) < 0)
+		return -1;
+
+	for (i = 0; i < n; i++)
+		if (unlock_mutex(ids[i]) < 0)
+			res = -1;
+	return res;
+}
+
+int sis_cerrar_mutex()
+{
+	unsigned int mutexid;
+	mutex *mut;
+	mutexid = (unsigned int)leer_registro(1);
+
+	// primero mira si el proceso ha abierto el mutex y obtiene su información
+	mut = obtener_mutex(mutexid);
+	if (mut == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el mutex %d.\n", mutexid);
+		return -1;
+	}
+
+	cerrar_desc_mutex(mutexid);
+
+	return 0;
+}
+
+/* Rutinas de cerrojos de lectores/escritores */
+
+int sis_crear_rwlock()
+{
+	char *nombre;
+	int opciones, pos, desc;
+	rwlock *rw;
+
+	nombre = (char *)leer_registro(1);
+	opciones = (int)leer_registro(2);
+
+	if (comprobar_creacion(nombre, hash_rwlock, TAM_HASH_RWLOCK) < 0)
+		return -1;
+
+	pos = buscar_rwlock_libre();
+	if (pos == -1)
+	{
+		printk_error("ERROR: no quedan cerrojos libres.\n");
+		return -1;
+	}
+
+	desc = reservar_descriptor(DESC_RWLOCK, pos);
+	if (desc == -1)
+		return -1;
+
+	rw = &tabla_rwlock[pos];
+	strcpy(rw->nombre, nombre);
+	rw->estado = EN_USO;
+	rw->pref_escritor = (opciones & RW_PREFERENCIA_ESCRITOR) != 0;
+	rw->n_lectores = 0;
+	rw->escritor = -1;
+	rw->n_opens = 1;
+	rw->lectores_esperando.primero = rw->lectores_esperando.ultimo = NULL;
+	rw->escritores_esperando.primero = rw->escritores_esperando.ultimo = NULL;
+	insertar_hash(hash_rwlock, TAM_HASH_RWLOCK, rw->nombre, pos);
+	return desc;
+}
+
+int sis_abrir_rwlock()
+{
+	char *nombre;
+	int pos, desc;
+
+	nombre = (char *)leer_registro(1);
+	pos = buscar_para_abrir(nombre, hash_rwlock, TAM_HASH_RWLOCK);
+	if (pos == -1)
+		return -1;
+
+	desc = reservar_descriptor(DESC_RWLOCK, pos);
+	if (desc != -1)
+		tabla_rwlock[pos].n_opens++;
+	return desc;
+}
+
+int sis_lock_lectura()
+{
+	unsigned int rwid;
+	rwlock *rw;
+	descriptor *d;
+
+	rwid = (unsigned int)leer_registro(1);
+	rw = obtener_rwlock(rwid);
+	if (rw == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el cerrojo %d.\n", rwid);
+		return -1;
+	}
+	d = &p_proc_actual->descs[rwid];
+	if (d->cogido)
+	{
+		printk_error("ERROR: el cerrojo %d ya esta cogido con ese descriptor.\n", rwid);
+		return -1;
+	}
+
+	// no se entra si hay un escritor dentro o, con preferencia de escritor,
+	// si alguno esta esperando
+	while (rw->escritor != -1 ||
+		   (rw->pref_escritor && rw->escritores_esperando.primero != NULL))
+		bloquear_proceso_actual(&rw->lectores_esperando);
+
+	rw->n_lectores++;
+	d->cogido = RW_LECTURA;
+	return 0;
+}
+
+int sis_lock_escritura()
+{
+	unsigned int rwid;
+	rwlock *rw;
+	descriptor *d;
+
+	rwid = (unsigned int)leer_registro(1);
+	rw = obtener_rwlock(rwid);
+	if (rw == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el cerrojo %d.\n", rwid);
+		return -1;
+	}
+	d = &p_proc_actual->descs[rwid];
+	if (d->cogido)
+	{
+		printk_error("ERROR: el cerrojo %d ya esta cogido con ese descriptor.\n", rwid);
+		return -1;
+	}
+
+	// el escritor necesita el cerrojo en exclusiva. Si ha esperado, al
+	// despertarle ya se le ha dado
+	if (rw->escritor == -1 && rw->n_lectores == 0)
+		rw->escritor = p_proc_actual->id;
+	while (rw->escritor != p_proc_actual->id)
+		bloquear_proceso_actual(&rw->escritores_esperando);
+
+	d->cogido = RW_ESCRITURA;
+	return 0;
+}
+
+int sis_unlock_rw()
+{
+	unsigned int rwid;
+	rwlock *rw;
+
+	rwid = (unsigned int)leer_registro(1);
+	rw = obtener_rwlock(rwid);
+	if (rw == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el cerrojo %d.\n", rwid);
+		return -1;
+	}
+	if (!p_proc_actual->descs[rwid].cogido)
+	{
+		printk_error("ERROR: el cerrojo %d no esta cogido con ese descriptor.\n", rwid);
+		return -1;
+	}
+
+	soltar_rwlock(rw, &p_proc_actual->descs[rwid]);
+	return 0;
+}
+
+int sis_cerrar_rwlock()
+{
+	unsigned int rwid;
+
+	rwid = (unsigned int)leer_registro(1);
+	if (obtener_rwlock(rwid) == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el cerrojo %d.\n", rwid);
+		return -1;
+	}
+
+	cerrar_desc_rwlock(rwid);
+	return 0;
+}
+
+/* Rutinas de semaforos */
+
+int sis_crear_sem()
+{
+	char *nombre;
+	int valor, pos, desc;
+	semaforo *sem;
+
+	nombre = (char *)leer_registro(1);
+	valor = (int)leer_registro(2);
+
+	if (valor < 0)
+	{
+		printk_error("ERROR: valor inicial de semaforo negativo.\n");
+		return -1;
+	}
+	if (comprobar_creacion(nombre, hash_sem, TAM_HASH_SEM) < 0)
+		return -1;
+
+	pos = buscar_sem_libre();
+	if (pos == -1)
+	{
+		printk_error("ERROR: no quedan semaforos libres.\n");
+		return -1;
+	}
+
+	desc = reservar_descriptor(DESC_SEMAFORO, pos);
+	if (desc == -1)
+		return -1;
+
+	sem = &tabla_sem[pos];
+	strcpy(sem->nombre, nombre);
+	sem->estado = EN_USO;
+	sem->valor = valor;
+	sem->n_opens = 1;
+	sem->procesos_esperando.primero = sem->procesos_esperando.ultimo = NULL;
+	insertar_hash(hash_sem, TAM_HASH_SEM, sem->nombre, pos);
+	return desc;
+}
+
+int sis_abrir_sem()
+{
+	int pos, desc;
+
+	pos = buscar_para_abrir((char *)leer_registro(1), hash_sem, TAM_HASH_SEM);
+	if (pos == -1)
+		return -1;
+
+	desc = reservar_descriptor(DESC_SEMAFORO, pos);
+	if (desc != -1)
+		tabla_sem[pos].n_opens++;
+	return desc;
+}
+
+int sis_wait_sem()
+{
+	unsigned int semid;
+	semaforo *sem;
+
+	semid = (unsigned int)leer_registro(1);
+	sem = obtener_sem(semid);
+	if (sem == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el semaforo %d.\n", semid);
+		return -1;
+	}
+
+	if (sem->valor > 0)
+		sem->valor--;
+	else // signal nos entrega directamente su unidad al despertarnos
+		bloquear_proceso_actual(&sem->procesos_esperando);
+	return 0;
+}
+
+int sis_signal_sem()
+{
+	unsigned int semid;
+	semaforo *sem;
+
+	semid = (unsigned int)leer_registro(1);
+	sem = obtener_sem(semid);
+	if (sem == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el semaforo %d.\n", semid);
+		return -1;
+	}
+
+	// si hay alguien esperando la unidad es para el; si no, se acumula
+	if (sem->procesos_esperando.primero != NULL)
+		desbloquear_proc_esperando(&sem->procesos_esperando);
+	else
+		sem->valor++;
+	return 0;
+}
+
+int sis_cerrar_sem()
+{
+	unsigned int semid;
+
+	semid = (unsigned int)leer_registro(1);
+	if (obtener_sem(semid) == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el semaforo %d.\n", semid);
+		return -1;
+	}
+
+	cerrar_desc_sem(semid);
+	return 0;
+}
+
+/* Rutinas de variables condicion */
+
+int sis_crear_cond()
+{
+	char *nombre;
+	int pos, desc;
+	condicion *cond;
+
+	nombre = (char *)leer_registro(1);
+	if (comprobar_creacion(nombre, hash_cond, TAM_HASH_COND) < 0)
+		return -1;
+
+	pos = buscar_cond_libre();
+	if (pos == -1)
+	{
+		printk_error("ERROR: no quedan variables condicion libres.\n");
+		return -1;
+	}
+
+	desc = reservar_descriptor(DESC_CONDICION, pos);
+	if (desc == -1)
+		return -1;
+
+	cond = &tabla_cond[pos];
+	strcpy(cond->nombre, nombre);
+	cond->estado = EN_USO;
+	cond->n_opens = 1;
+	cond->procesos_esperando.primero = cond->procesos_esperando.ultimo = NULL;
+	insertar_hash(hash_cond, TAM_HASH_COND, cond->nombre, pos);
+	return desc;
+}
+
+int sis_abrir_cond()
+{
+	int pos, desc;
+
+	pos = buscar_para_abrir((char *)leer_registro(1), hash_cond, TAM_HASH_COND);
+	if (pos == -1)
+		return -1;
+
+	desc = reservar_descriptor(DESC_CONDICION, pos);
+	if (desc != -1)
+		tabla_cond[pos].n_opens++;
+	return desc;
+}
+
+int sis_wait_cond()
+{
+	unsigned int condid, mutexid;
+	int n_blocks;
+	condicion *cond;
+	mutex *mut;
+
+	condid = (unsigned int)leer_registro(1);
+	mutexid = (unsigned int)leer_registro(2);
+
+	cond = obtener_cond(condid);
+	if (cond == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto la condicion %d.\n", condid);
+		return -1;
+	}
+	mut = obtener_mutex(mutexid);
+	if (mut == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el mutex %d.\n", mutexid);
+		return -1;
+	}
+	if (PROPIETARIO_MUTEX(mut) != p_proc_actual->id)
+	{
+		printk_error("ERROR: el mutex %d no esta bloqueado por el proceso actual.\n", mutexid);
+		return -1;
+	}
+
+	// se suelta el mutex del todo y se espera en la condicion sin que pueda
+	// colarse un signal entre medias, ya que el kernel no es expulsivo
+	n_blocks = mut->compartido.n_blocks;
+	soltar_mutex(mut);
+	bloquear_proceso_actual(&cond->procesos_esperando);
+
+	// al despertar se vuelve a coger el mutex como estaba
+	coger_mutex(mut, ESPERA_INDEFINIDA);
+	mut->compartido.n_blocks = n_blocks;
+	return 0;
+}
+
+int sis_signal_cond()
+{
+	unsigned int condid;
+	condicion *cond;
+
+	condid = (unsigned int)leer_registro(1);
+	cond = obtener_cond(condid);
+	if (cond == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto la condicion %d.\n", condid);
+		return -1;
+	}
+
+	desbloquear_proc_esperando(&cond->procesos_esperando);
+	return 0;
+}
+
+int sis_broadcast_cond()
+{
+	unsigned int condid;
+	condicion *cond;
+
+	condid = (unsigned int)leer_registro(1);
+	cond = obtener_cond(condid);
+	if (cond == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto la condicion %d.\n", condid);
+		return -1;
+	}
+
+	desbloquear_todos(&cond->procesos_esperando);
+	return 0;
+}
+
+int sis_cerrar_cond()
+{
+	unsigned int condid;
+
+	condid = (unsigned int)leer_registro(1);
+	if (obtener_cond(condid) == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto la condicion %d.\n", condid);
+		return -1;
+	}
+
+	cerrar_desc_cond(condid);
+	return 0;
+}
+
+/* Rutinas de barreras */
+
+int sis_crear_barrera()
+{
+	char *nombre;
+	int participantes, pos, desc;
+	barrera *bar;
+
+	nombre = (char *)leer_registro(1);
+	participantes = (int)leer_registro(2);
+
+	if (participantes <= 0)
+	{
+		printk_error("ERROR: numero de participantes de barrera no valido.\n");
+		return -1;
+	}
+	if (comprobar_creacion(nombre, hash_barrera, TAM_HASH_BARRERA) < 0)
+		return -1;
+
+	pos = buscar_barrera_libre();
+	if (pos == -1)
+	{
+		printk_error("ERROR: no quedan barreras libres.\n");
+		return -1;
+	}
+
+	desc = reservar_descriptor(DESC_BARRERA, pos);
+	if (desc == -1)
+		return -1;
+
+	bar = &tabla_barrera[pos];
+	strcpy(bar->nombre, nombre);
+	bar->estado = EN_USO;
+	bar->n_participantes = participantes;
+	bar->n_llegados = 0;
+	bar->n_opens = 1;
+	bar->procesos_esperando.primero = bar->procesos_esperando.ultimo = NULL;
+	insertar_hash(hash_barrera, TAM_HASH_BARRERA, bar->nombre, pos);
+	return desc;
+}
+
+int sis_abrir_barrera()
+{
+	int pos, desc;
+
+	pos = buscar_para_abrir((char *)leer_registro(1), hash_barrera, TAM_HASH_BARRERA);
+	if (pos == -1)
+		return -1;
+
+	desc = reservar_descriptor(DESC_BARRERA, pos);
+	if (desc != -1)
+		tabla_barrera[pos].n_opens++;
+	return desc;
+}
+
+/*
+ * Espera a que lleguen a la barrera todos los participantes. El ultimo en
+ * llegar despierta a los demas de una vez y deja la barrera preparada para
+ * la siguiente fase. Devuelve 1 al ultimo en llegar y 0 al resto
+ */
+int sis_barrera_esperar()
+{
+	unsigned int barid;
+	barrera *bar;
+
+	barid = (unsigned int)leer_registro(1);
+	bar = obtener_barrera(barid);
+	if (bar == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto la barrera %d.\n", barid);
+		return -1;
+	}
+
+	if (++bar->n_llegados < bar->n_participantes)
+	{
+		bloquear_proceso_actual(&bar->procesos_esperando);
+		return 0;
+	}
+
+	bar->n_llegados = 0;
+	desbloquear_todos(&bar->procesos_esperando);
+	return 1;
+}
+
+int sis_cerrar_barrera()
+{
+	unsigned int barid;
+
+	barid = (unsigned int)leer_registro(1);
+	if (obtener_barrera(barid) == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto la barrera %d.\n", barid);
+		return -1;
+	}
+
+	cerrar_desc_barrera(barid);
+	return 0;
+}
+
+/* Rutinas de contadores */
+
+int sis_crear_contador()
+{
+	char *nombre;
+	int valor, pos, desc;
+	contador *cont;
+
+	nombre = (char *)leer_registro(1);
+	valor = (int)leer_registro(2);
+
+	if (comprobar_creacion(nombre, hash_contador, TAM_HASH_CONTADOR) < 0)
+		return -1;
+
+	pos = buscar_contador_libre();
+	if (pos == -1)
+	{
+		printk_error("ERROR: no quedan contadores libres.\n");
+		return -1;
+	}
+
+	desc = reservar_descriptor(DESC_CONTADOR, pos);
+	if (desc == -1)
+		return -1;
+
+	cont = &tabla_contador[pos];
+	strcpy(cont->nombre, nombre);
+	cont->estado = EN_USO;
+	cont->valor = valor;
+	cont->n_opens = 1;
+	cont->procesos_esperando.primero = cont->procesos_esperando.ultimo = NULL;
+	insertar_hash(hash_contador, TAM_HASH_CONTADOR, cont->nombre, pos);
+	return desc;
+}
+
+int sis_abrir_contador()
+{
+	int pos, desc;
+
+	pos = buscar_para_abrir((char *)leer_registro(1), hash_contador, TAM_HASH_CONTADOR);
+	if (pos == -1)
+		return -1;
+
+	desc = reservar_descriptor(DESC_CONTADOR, pos);
+	if (desc != -1)
+		tabla_contador[pos].n_opens++;
+	return desc;
+}
+
+// Rutina comun que obtiene el contador del descriptor pasado como primer
+// parametro de la llamada, informando del error si no lo es
+static contador *contador_parametro()
+{
+	unsigned int contid;
+	contador *cont;
+
+	contid = (unsigned int)leer_registro(1);
+	cont = obtener_contador(contid);
+	if (cont == NULL)
+		printk_error("ERROR: el proceso no ha abierto el contador %d.\n", contid);
+	return cont;
+}
+
+/* Deja en la zona de usuario el valor del contador */
+int sis_contador_leer()
+{
+	contador *cont;
+	int *valor;
+
+	if ((cont = contador_parametro()) == NULL)
+		return -1;
+	valor = (int *)leer_registro(2);
+
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	*valor = cont->valor;
+	acceso_parametro = 0;
+	return 0;
+}
+
+/* Suma al contador el incremento indicado y deja en la zona de usuario el
+   valor que tenia antes, si se pasa donde */
+int sis_contador_sumar()
+{
+	contador *cont;
+	int *anterior;
+
+	if ((cont = contador_parametro()) == NULL)
+		return -1;
+	anterior = (int *)leer_registro(3);
+
+	if (anterior != NULL)
+	{
+		acceso_parametro = 1;
+		*anterior = cont->valor;
+		acceso_parametro = 0;
+	}
+	cont->valor += (int)leer_registro(2);
+	despertar_contador(cont);
+	return 0;
+}
+
+/* Si el contador vale lo esperado le asigna el nuevo valor. Devuelve 1 si
+   lo ha cambiado y 0 si no */
+int sis_contador_cas()
+{
+	contador *cont;
+
+	if ((cont = contador_parametro()) == NULL)
+		return -1;
+
+	if (cont->valor != (int)leer_registro(2))
+		return 0;
+	cont->valor = (int)leer_registro(3);
+	despertar_contador(cont);
+	return 1;
+}
+
+/* Espera a que el contador alcance al menos el valor indicado */
+int sis_contador_esperar()
+{
+	contador *cont;
+
+	if ((cont = contador_parametro()) == NULL)
+		return -1;
+
+	p_proc_actual->objetivo_contador = (int)leer_registro(2);
+	if (cont->valor < p_proc_actual->objetivo_contador)
+		bloquear_proceso_actual(&cont->procesos_esperando);
+	return 0;
+}
+
+int sis_cerrar_contador()
+{
+	unsigned int contid;
+
+	contid = (unsigned int)leer_registro(1);
+	if (obtener_contador(contid) == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el contador %d.\n", contid);
+		return -1;
+	}
+
+	cerrar_desc_contador(contid);
+	return 0;
+}
+
+/* Rutinas de tuberias */
+
+int sis_crear_tuberia()
+{
+	char *nombre;
+	int modo, pos, desc;
+	tuberia *tub;
+
+	nombre = (char *)leer_registro(1);
+	modo = (int)leer_registro(2);
+
+	if (modo != TUB_LECTURA && modo != TUB_ESCRITURA)
+	{
+		printk_error("ERROR: modo de apertura de tuberia %d no valido.\n", modo);
+		return -1;
+	}
+
+	if (comprobar_creacion(nombre, hash_tuberia, TAM_HASH_TUBERIA) < 0)
+		return -1;
+
+	pos = buscar_tuberia_libre();
+	if (pos == -1)
+	{
+		printk_error("ERROR: no quedan tuberias libres.\n");
+		return -1;
+	}
+
+	tub = &tabla_tuberia[pos];
+	tub->primero = tub->ocupados = 0;
+	tub->n_lectores = tub->n_escritores = 0;
+	tub->hubo_lector = tub->hubo_escritor = 0;
+	tub->lectores_esperando.primero = tub->lectores_esperando.ultimo = NULL;
+	tub->escritores_esperando.primero = tub->escritores_esperando.ultimo = NULL;
+
+	// la tuberia solo se da de alta si el proceso ha podido abrirla
+	desc = abrir_extremo_tuberia(pos, modo);
+	if (desc == -1)
+		return -1;
+
+	strcpy(tub->nombre, nombre);
+	tub->estado = EN_USO;
+	insertar_hash(hash_tuberia, TAM_HASH_TUBERIA, tub->nombre, pos);
+	return desc;
+}
+
+int sis_abrir_tuberia()
+{
+	int modo, pos;
+
+	modo = (int)leer_registro(2);
+	if (modo != TUB_LECTURA && modo != TUB_ESCRITURA)
+	{
+		printk_error("ERROR: modo de apertura de tuberia %d no valido.\n", modo);
+		return -1;
+	}
+
+	pos = buscar_para_abrir((char *)leer_registro(1), hash_tuberia, TAM_HASH_TUBERIA);
+	if (pos == -1)
+		return -1;
+
+	return abrir_extremo_tuberia(pos, modo);
+}
+
+// Rutina comun que obtiene la tuberia del descriptor pasado como primer
+// parametro de la llamada, que debe ser un extremo del tipo indicado
+static tuberia *tuberia_parametro(int tipo)
+{
+	unsigned int tubid;
+	tuberia *tub;
+
+	tubid = (unsigned int)leer_registro(1);
+	tub = obtener_tuberia(tubid, tipo);
+	if (tub == NULL)
+		printk_error("ERROR: el proceso no ha abierto para %s la tuberia %d.\n",
+					 tipo == DESC_TUB_LECTURA ? "leer" : "escribir", tubid);
+	return tub;
+}
+
+/* Lee de la tuberia hasta tam bytes, bloqueandose mientras este vacia.
+   Devuelve los bytes leidos, que pueden ser menos de los pedidos, o 0 si
+   esta vacia y ya se ha cerrado el ultimo extremo de escritura */
+int sis_leer_tuberia()
+{
+	tuberia *tub;
+	char *buf;
+	int tam, n, parte;
+
+	if ((tub = tuberia_parametro(DESC_TUB_LECTURA)) == NULL)
+		return -1;
+	buf = (char *)leer_registro(2);
+	tam = (int)leer_registro(3);
+	if (tam <= 0)
+		return tam < 0 ? -1 : 0;
+
+	// mientras nadie la haya abierto para escribir tambien se espera
+	while (tub->ocupados == 0 && (tub->n_escritores > 0 || !tub->hubo_escritor))
+		bloquear_proceso_actual(&tub->lectores_esperando);
+
+	n = tam < tub->ocupados ? tam : tub->ocupados;
+	if (n == 0)
+		return 0;
+
+	// se copia en dos partes si los datos dan la vuelta al buffer
+	parte = TAM_TUBERIA - tub->primero;
+	if (parte > n)
+		parte = n;
+
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	memcpy(buf, &tub->datos[tub->primero], parte);
+	memcpy(buf + parte, tub->datos, n - parte);
+	acceso_parametro = 0;
+
+	tub->primero = (tub->primero + n) % TAM_TUBERIA;
+	tub->ocupados -= n;
+	desbloquear_todos(&tub->escritores_esperando);
+	return n;
+}
+
+/* Escribe en la tuberia tam bytes, bloqueandose cada vez que se llena.
+   Si se cierra el ultimo extremo de lectura deja de escribir y devuelve lo
+   que haya escrito hasta entonces, o -1 si no ha escrito nada */
+int sis_escribir_tuberia()
+{
+	tuberia *tub;
+	char *buf;
+	int tam, escritos, n, fin, parte;
+
+	if ((tub = tuberia_parametro(DESC_TUB_ESCRITURA)) == NULL)
+		return -1;
+	buf = (char *)leer_registro(2);
+	tam = (int)leer_registro(3);
+	if (tam < 0)
+		return -1;
+
+	for (escritos = 0; escritos < tam; escritos += n)
+	{
+		// mientras nadie la haya abierto para leer tambien se espera
+		while (tub->ocupados == TAM_TUBERIA && (tub->n_lectores > 0 || !tub->hubo_lector))
+			bloquear_proceso_actual(&tub->escritores_esperando);
+
+		// nadie va a leer ya lo que se escriba
+		if (tub->n_lectores == 0 && tub->hubo_lector)
+		{
+			printk_aviso("WARNING: tuberia %s sin lectores.\n", tub->nombre);
+			return escritos > 0 ? escritos : -1;
+		}
+
+		n = tam - escritos;
+		if (n > TAM_TUBERIA - tub->ocupados)
+			n = TAM_TUBERIA - tub->ocupados;
+		fin = (tub->primero + tub->ocupados) % TAM_TUBERIA;
+		parte = TAM_TUBERIA - fin;
+		if (parte > n)
+			parte = n;
+
+		acceso_parametro = 1;
+		memcpy(&tub->datos[fin], buf + escritos, parte);
+		memcpy(tub->datos, buf + escritos + parte, n - parte);
+		acceso_parametro = 0;
+
+		tub->ocupados += n;
+		desbloquear_todos(&tub->lectores_esperando);
+	}
+	return escritos;
+}
+
+int sis_cerrar_tuberia()
+{
+	unsigned int tubid;
+
+	tubid = (unsigned int)leer_registro(1);
+	if (obtener_tuberia(tubid, DESC_TUB_LECTURA) == NULL &&
+		obtener_tuberia(tubid, DESC_TUB_ESCRITURA) == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto la tuberia %d.\n", tubid);
+		return -1;
+	}
+
+	cerrar_desc_tuberia(tubid);
+	return 0;
+}
+
+/* Rutinas de memoria compartida. Todos los procesos estan en el mismo
+   espacio de direcciones, asi que asociarse a un segmento consiste en
+   obtener la direccion de la zona que reserva el kernel al crearlo */
+
+// Rutina que deja en la zona de usuario la direccion del segmento
+static void devolver_dir_memoria(memoria *mem, void **dir)
+{
+	acceso_parametro = 1;
+	*dir = mem->dir;
+	acceso_parametro = 0;
+}
+
+int sis_crear_memoria()
+{
+	char *nombre;
+	int tam, pos, desc;
+	memoria *mem;
+
+	nombre = (char *)leer_registro(1);
+	tam = (int)leer_registro(2);
+
+	if (tam <= 0 || tam > MAX_TAM_MEMORIA)
+	{
+		printk_error("ERROR: tamaño de memoria compartida %d no valido.\n", tam);
+		return -1;
+	}
+
+	if (comprobar_creacion(nombre, hash_memoria, TAM_HASH_MEMORIA) < 0)
+		return -1;
+
+	pos = buscar_memoria_libre();
+	if (pos == -1)
+	{
+		printk_error("ERROR: no quedan segmentos de memoria compartida libres.\n");
+		return -1;
+	}
+
+	// el descriptor se reserva antes de dar de alta el segmento y de
+	// escribir en la zona de usuario, para que se libere el segmento si el
+	// proceso muere por la excepcion
+	desc = reservar_descriptor(DESC_MEMORIA, pos);
+	if (desc == -1)
+		return -1;
+
+	mem = &tabla_memoria[pos];
+	if ((mem->dir = calloc(1, tam)) == NULL)
+	{
+		printk_error("ERROR: no hay memoria para el segmento %s.\n", nombre);
+		liberar_descriptor(desc);
+		return -1;
+	}
+	strcpy(mem->nombre, nombre);
+	mem->estado = EN_USO;
+	mem->tam = tam;
+	mem->n_opens = 1;
+	mem->destruido = 0;
+	insertar_hash(hash_memoria, TAM_HASH_MEMORIA, mem->nombre, pos);
+
+	devolver_dir_memoria(mem, (void **)leer_registro(3));
+	return desc;
+}
+
+int sis_asociar_memoria()
+{
+	int pos, desc;
+
+	pos = buscar_para_abrir((char *)leer_registro(1), hash_memoria, TAM_HASH_MEMORIA);
+	if (pos == -1)
+		return -1;
+
+	// sin descriptor no se cuenta la asociacion ni se da la direccion
+	desc = reservar_descriptor(DESC_MEMORIA, pos);
+	if (desc == -1)
+		return -1;
+	tabla_memoria[pos].n_opens++;
+	devolver_dir_memoria(&tabla_memoria[pos], (void **)leer_registro(2));
+	return desc;
+}
+
+int sis_desasociar_memoria()
+{
+	unsigned int memid;
+
+	memid = (unsigned int)leer_registro(1);
+	if (obtener_memoria(memid) == NULL)
+	{
+		printk_error("ERROR: el proceso no esta asociado al segmento %d.\n", memid);
+		return -1;
+	}
+
+	cerrar_desc_memoria(memid);
+	return 0;
+}
+
+/* Quita el nombre del segmento para que nadie mas se pueda asociar. La
+   zona sigue siendo valida hasta que se desasocien los que ya lo estan */
+int sis_destruir_memoria()
+{
+	char *nombre;
+	int pos;
+
+	nombre = (char *)leer_registro(1);
+	pos = buscar_hash(hash_memoria, TAM_HASH_MEMORIA, nombre);
+	if (pos == -1)
+	{
+		printk_error("ERROR: no existe %s.\n", nombre);
+		return -1;
+	}
+
+	tabla_memoria[pos].destruido = 1;
+	eliminar_hash(hash_memoria, TAM_HASH_MEMORIA, tabla_memoria[pos].nombre);
+	return 0;
+}
+
+/* Rutinas de buzones */
+
+int sis_crear_buzon()
+{
+	char *nombre;
+	int profundidad, pos, desc;
+	buzon *buz;
+
+	nombre = (char *)leer_registro(1);
+	profundidad = (int)leer_registro(2);
+
+	if (profundidad <= 0 || profundidad > MAX_MENSAJES_BUZON)
+	{
+		printk_error("ERROR: profundidad de buzon %d no valida.\n", profundidad);
+		return -1;
+	}
+
+	if (comprobar_creacion(nombre, hash_buzon, TAM_HASH_BUZON) < 0)
+		return -1;
+
+	pos = buscar_buzon_libre();
+	if (pos == -1)
+	{
+		printk_error("ERROR: no quedan buzones libres.\n");
+		return -1;
+	}
+
+	desc = reservar_descriptor(DESC_BUZON, pos);
+	if (desc == -1)
+		return -1;
+
+	buz = &tabla_buzon[pos];
+	strcpy(buz->nombre, nombre);
+	buz->estado = EN_USO;
+	buz->profundidad = profundidad;
+	buz->primero = buz->ocupados = 0;
+	buz->n_opens = 1;
+	memset(&buz->estad, 0, sizeof(buz->estad));
+	buz->emisores.primero = buz->emisores.ultimo = NULL;
+	buz->receptores.primero = buz->receptores.ultimo = NULL;
+	insertar_hash(hash_buzon, TAM_HASH_BUZON, buz->nombre, pos);
+	return desc;
+}
+
+int sis_abrir_buzon()
+{
+	int pos, desc;
+
+	pos = buscar_para_abrir((char *)leer_registro(1), hash_buzon, TAM_HASH_BUZON);
+	if (pos == -1)
+		return -1;
+
+	desc = reservar_descriptor(DESC_BUZON, pos);
+	if (desc != -1)
+		tabla_buzon[pos].n_opens++;
+	return desc;
+}
+
+// Rutina comun que obtiene el buzon del descriptor pasado como primer
+// parametro de la llamada, informando del error si no lo es
+static buzon *buzon_parametro()
+{
+	unsigned int buzid;
+	buzon *buz;
+
+	buzid = (unsigned int)leer_registro(1);
+	buz = obtener_buzon(buzid);
+	if (buz == NULL)
+		printk_error("ERROR: el proceso no ha abierto el buzon %d.\n", buzid);
+	return buz;
+}
+
+/* Envia un mensaje de TAM_MENSAJE bytes esperando como mucho el plazo
+   indicado (0 no espera, negativo sin limite) a que haya hueco. Si hay un
+   receptor esperando, la cola esta vacia y se le copia directamente */
+int sis_enviar_mensaje()
+{
+	buzon *buz;
+	BCP *receptor;
+	char *msg;
+	int plazo, nivel_previo, esperado = 0;
+
+	if ((buz = buzon_parametro()) == NULL)
+		return -1;
+	msg = (char *)leer_registro(2);
+	plazo = (int)leer_registro(3);
+
+	// el plazo es para toda la espera, aunque otro emisor se adelante
+	p_proc_actual->ticks_plazo = plazo > 0 ? plazo : 0;
+	p_proc_actual->plazo_vencido = 0;
+	p_proc_actual->inicio_espera = num_ints;
+
+	for (;;)
+	{
+		// se saca al receptor de la lista con el reloj inhibido para que no
+		// le venza el plazo entre medias; una vez listo el reloj ya no lo
+		// descuenta. No se ejecuta hasta que volvamos
+		nivel_previo = fijar_nivel_int(NIVEL_3);
+		receptor = buz->receptores.primero;
+		if (receptor != NULL)
+			desbloquear_proceso(&buz->receptores, receptor);
+		fijar_nivel_int(nivel_previo);
+
+		if (receptor != NULL)
+		{
+			// si el emisor muere en la copia el receptor vuelve a esperar
+			// con lo que le quedara de plazo, que borra el mismo al volver
+			acceso_parametro = 1;
+			memcpy(receptor->buf_mensaje, msg, TAM_MENSAJE);
+			acceso_parametro = 0;
+			receptor->mensaje_recibido = 1;
+			buz->estad.traspasos++;
+			break;
+		}
+
+		if (buz->ocupados < buz->profundidad)
+		{
+			acceso_parametro = 1;
+			memcpy(buz->mensajes[(buz->primero + buz->ocupados) % buz->profundidad],
+				   msg, TAM_MENSAJE);
+			acceso_parametro = 0;
+			if (++buz->ocupados > buz->estad.max_ocupados)
+				buz->estad.max_ocupados = buz->ocupados;
+			break;
+		}
+
+		if (plazo == 0)
+			return -1;
+
+		bloquear_proceso_actual(&buz->emisores);
+		esperado = 1;
+		if (p_proc_actual->plazo_vencido)
+		{
+			buz->estad.espera_envio += num_ints - p_proc_actual->inicio_espera;
+			return -1;
+		}
+	}
+	p_proc_actual->ticks_plazo = 0;
+
+	if (esperado)
+		buz->estad.espera_envio += num_ints - p_proc_actual->inicio_espera;
+	buz->estad.enviados++;
+	return 0;
+}
+
+/* Recibe en buf un mensaje esperando como mucho el plazo indicado (0 no
+   espera, negativo sin limite) a que llegue */
+int sis_recibir_mensaje()
+{
+	buzon *buz;
+	char *buf;
+	int plazo, esperado = 0;
+
+	if ((buz = buzon_parametro()) == NULL)
+		return -1;
+	buf = (char *)leer_registro(2);
+	plazo = (int)leer_registro(3);
+
+	// si espera, el emisor le copiara el mensaje en buf desde su propia
+	// llamada, asi que se comprueba ahora que se puede escribir en el
+	acceso_parametro = 1;
+	memset(buf, 0, TAM_MENSAJE);
+	acceso_parametro = 0;
+	p_proc_actual->buf_mensaje = buf;
+	p_proc_actual->mensaje_recibido = 0;
+
+	p_proc_actual->ticks_plazo = plazo > 0 ? plazo : 0;
+	p_proc_actual->plazo_vencido = 0;
+	p_proc_actual->inicio_espera = num_ints;
+
+	while (buz->ocupados == 0 && !p_proc_actual->mensaje_recibido)
+	{
+		if (plazo == 0 || p_proc_actual->plazo_vencido)
+			break;
+
+		bloquear_proceso_actual(&buz->receptores);
+		esperado = 1;
+	}
+	p_proc_actual->ticks_plazo = 0;
+
+	if (esperado)
+		buz->estad.espera_recepcion += num_ints - p_proc_actual->inicio_espera;
+
+	if (!p_proc_actual->mensaje_recibido)
+	{
+		if (buz->ocupados == 0)
+			return -1;
+
+		acceso_parametro = 1;
+		memcpy(buf, buz->mensajes[buz->primero], TAM_MENSAJE);
+		acceso_parametro = 0;
+		buz->primero = (buz->primero + 1) % buz->profundidad;
+		buz->ocupados--;
+
+		// queda hueco para un emisor que espera
+		desbloquear_proc_esperando(&buz->emisores);
+	}
+	buz->estad.recibidos++;
+	return 0;
+}
+
+int sis_cerrar_buzon()
+{
+	unsigned int buzid;
+
+	buzid = (unsigned int)leer_registro(1);
+	if (obtener_buzon(buzid) == NULL)
+	{
+		printk_error("ERROR: el proceso no ha abierto el buzon %d.\n", buzid);
+		return -1;
+	}
+
+	cerrar_desc_buzon(buzid);
+	return 0;
+}
+
+/* Copia en la zona de usuario las estadisticas del buzon */
+int sis_leer_estad_buzon()
 {
-	char *prog;
-	int res;
+	buzon *buz;
+	estad_buzon *estad;
 
-	printk("-> PROC %d: CREAR PROCESO\n", p_proc_actual->id);
-	prog = (char *)leer_registro(1);
-	res = crear_tarea(prog);
-	return res;
+	if ((buz = buzon_parametro()) == NULL)
+		return -1;
+	estad = (estad_buzon *)leer_registro(2);
+
+	buz->estad.profundidad = buz->profundidad;
+	buz->estad.ocupados = buz->ocupados;
+
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	*estad = buz->estad;
+	acceso_parametro = 0;
+	return 0;
 }
 
 /*
- * Tratamiento de llamada al sistema escribir. Llama simplemente a la
- * funcion de apoyo escribir_ker
+ * Copia en la zona de usuario el nombre y las estadisticas del mutex que
+ * ocupa la posicion pos de la tabla. Devuelve 0 si esta en uso, 1 si esa
+ * entrada esta libre y -1 si pos se sale de la tabla
  */
-int sis_escribir()
+int sis_leer_estad_mutex()
 {
-	char *texto;
-	unsigned int longi;
+	int pos;
+	char *nombre;
+	estad_mutex *estad;
+	mutex *mut;
 
-	texto = (char *)leer_registro(1);
-	longi = (unsigned int)leer_registro(2);
+	pos = (int)leer_registro(1);
+	nombre = (char *)leer_registro(2);
+	estad = (estad_mutex *)leer_registro(3);
 
-	escribir_ker(texto, longi);
+	if (pos < 0 || pos >= TAM_TABLA_MUTEX)
+		return -1;
+	mut = MUTEX_POS(pos);
+	if (mut->estado == SIN_USAR)
+		return 1;
+
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	strncpy(nombre, mut->nombre, MAX_NOM_MUT);
+	nombre[MAX_NOM_MUT] = '\0';
+	*estad = mut->compartido.estad;
+	acceso_parametro = 0;
 	return 0;
 }
 
+/* entrada por teclado */
+
 /*
- * Tratamiento de llamada al sistema terminar_proceso. Llama a la
- * funcion auxiliar liberar_proceso
+ * Bloquea al proceso actual mientras no haya caracteres que leer, como mucho
+ * durante el plazo indicado (0 no espera, ESPERA_INDEFINIDA sin limite).
+ * Devuelve -1 si vence el plazo. Se llama con las interrupciones del
+ * terminal inhibidas
  */
-int sis_terminar_proceso()
+static int esperar_caracteres(int plazo)
 {
+	// el plazo es para toda la espera, aunque otro lector se adelante
+	p_proc_actual->ticks_plazo = plazo > 0 ? plazo : 0;
+	p_proc_actual->plazo_vencido = 0;
 
-	printk("-> FIN PROCESO %d\n", p_proc_actual->id);
-
-	liberar_proceso();
+	while (contDisponibles == 0)
+	{
+		if (plazo == 0)
+			return -1;
 
-	return 0; /* no deber�a llegar aqui */
+		bloquear_proceso_actual(&lista_bloq_lectura);
+		if (p_proc_actual->plazo_vencido)
+			return -1;
+	}
+	p_proc_actual->ticks_plazo = 0;
+	return 0;
 }
 
-/* Rutina que devuelve el ID del proceso */
-int sis_obtener_id_pr()
+/*
+ * Si tras una lectura quedan caracteres disponibles se despierta a otro
+ * lector, ya que solo se desperto a uno cuando llegaron
+ */
+static void pasar_caracteres()
 {
-	return p_proc_actual->id;
+	if (contDisponibles > 0)
+		desbloquear_proc_esperando(&lista_bloq_lectura);
 }
 
-/* Rutina que duerme al proceso actual n segundos */
-int sis_dormir()
+int sis_leer_caracter()
 {
-	unsigned int segundos;
-	int nivel_previo;
-	BCP *proc_a_dormir;
-	segundos = (unsigned int)leer_registro(1);
-
-	// indicamos ticks iniciales de bloqueo
-	p_proc_actual->ticks_bloq = (segundos * TICK);
-	p_proc_actual->estado = BLOQUEADO;
-	proc_a_dormir = p_proc_actual;
+	int nivel_previo, caracter;
 
-	// inhabilitamos todas las interrupciones
-	nivel_previo = fijar_nivel_int(NIVEL_3);
+	// inhibilitamos interrupciones de nivel 2 para que no lleguen caracteres entre medias
+	nivel_previo = fijar_nivel_int(NIVEL_2);
 
-	// sacamos el proceso actual de la lista de listos
-	eliminar_elem(&lista_listos, p_proc_actual);
+	// mientras no haya caracteres por leer se bloquea
+	esperar_caracteres(ESPERA_INDEFINIDA);
 
-	// insertamos proceso bloqueado en la lista pertinente
-	insertar_ultimo(&lista_bloq, p_proc_actual);
+	caracter = sacar_primer_caracter();
+	pasar_caracteres();
 
-	// volvemos al nivel anterior
+	// volvemos a activar interrupciones
 	fijar_nivel_int(nivel_previo);
 
-	// siguiente proceso
-	p_proc_actual = planificador();
-	cambio_contexto(&proc_a_dormir->contexto_regs, &p_proc_actual->contexto_regs);
-	return 0;
-}
-
-/* Rutina que  contabiliza el uso del procesador por parte de un proceso */
-int sis_tiempos_proceso()
-{
-	struct tiempos_ejec_t *tiempos;
-	int nivel_previo;
-	tiempos = (struct tiempos_ejec_t *)leer_registro(1);
-
-	if (tiempos != NULL)
-	{
-		// inhabilitamos todas las interrupciones
-		nivel_previo = fijar_nivel_int(NIVEL_3);
-		// controlamos acceso por si hay excepción
-		acceso_parametro = 1;
-
-		tiempos->sistema = p_proc_actual->int_sistema;
-		tiempos->usuario = p_proc_actual->int_usuario;
-
-		acceso_parametro = 0;
-		// volvemos al nivel anterior
-		fijar_nivel_int(nivel_previo);
-	}
-
-	return num_ints;
+	return caracter;
 }
 
-/* Rutinas mutex */
-
-int sis_crear_mutex()
+/*
+ * Lee de una vez todos los caracteres disponibles hasta un maximo de n,
+ * bloqueandose solo si no hay ninguno y como mucho durante el plazo. En
+ * modo linea devuelve como mucho una linea, incluido su fin de linea
+ */
+static int leer_con_plazo(char *buf, int n, int plazo)
 {
-	char *nombre;
-	int tipo, pos, descriptor, nivel_previo, se_ha_bloqueado = 0;
-	BCP *proc_a_bloquear;
-
-	nombre = (char *)leer_registro(1);
-	tipo = (int)leer_registro(2);
-
-	// si se pasa del tamaño maximo se devuelve un error
-	if (strlen(nombre) > MAX_NOM_MUT)
-	{
-		printk("ERROR: nombre de mutex demaisado largo.\n");
-		return -1;
-	}
+	int leidos, nivel_previo;
+	char car, copia[TAM_BUF_TERM];
 
-	// miramos si al proceso actual le quedan descriptores de mutex libres
-	descriptor = get_free_mutex_descrp();
-	if (descriptor == -1)
-	{
-		printk("ERROR: proceso actual no tiene descriptores de mutex libres.\n");
+	if (n < 0)
 		return -1;
-	}
+	if (n > TAM_BUF_TERM)
+		n = TAM_BUF_TERM;
+	if (n == 0)
+		return 0;
 
-	// si ya existe ese nombre en la tabla de mutex devuelve error
-	pos = buscar_nombre_mutex(nombre);
-	if (pos != -1)
+	nivel_previo = fijar_nivel_int(NIVEL_2);
+	if (esperar_caracteres(plazo) < 0)
 	{
-		printk("ERROR: nombre de Mutex %s en uso.\n", nombre);
+		fijar_nivel_int(nivel_previo);
 		return -1;
 	}
 
-	// si se ha alcanzado el numero maximo de mutex se bloquea hasta que se puedan crear mas
-	while (n_mutex_open >= NUM_MUT)
+	leidos = 0;
+	do
 	{
-		se_ha_bloqueado = 1;
-		printk("WARNING: proceso actual bloqueado, no se pueden hacer mas mutex.\n");
-		nivel_previo = fijar_nivel_int(3);
-
-		p_proc_actual->estado = BLOQUEADO;
-		proc_a_bloquear = p_proc_actual;
-		// sacamos el proceso actual de la lista de listos
-		eliminar_elem(&lista_listos, p_proc_actual);
-
-		// insertamos proceso bloqueado en la lista pertinente
-		insertar_ultimo(&lista_bloq_mutex, p_proc_actual);
-
-		fijar_nivel_int(nivel_previo);
-
-		// siguiente proceso
-		p_proc_actual = planificador();
-		cambio_contexto(&proc_a_bloquear->contexto_regs, &p_proc_actual->contexto_regs);
-	}
+		car = sacar_primer_caracter();
+		copia[leidos++] = car;
+	} while (leidos < n && contDisponibles > 0 && !(modoTerminal == TERM_LINEA && car == '\n'));
+	pasar_caracteres();
+	fijar_nivel_int(nivel_previo);
 
-	// si se ha bloqueado, hay que volver a comprobar si durante ese tiempo alguien ha creado un mutex con el mismo nombre
-	if (se_ha_bloqueado)
-	{
-		pos = buscar_nombre_mutex(nombre);
-		if (pos != -1)
-		{
-			printk("ERROR: nombre de Mutex en uso.\n");
-			return -1;
-		}
-	}
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	memcpy(buf, copia, leidos);
+	acceso_parametro = 0;
+	return leidos;
+}
 
-	// se crea por fin el mutex en una posicion libre
-	pos = buscar_mutex_libre();
-	strcpy(tabla_mutex[pos].nombre, nombre);
-	tabla_mutex[pos].id = pos;
-	tabla_mutex[pos].tipo = tipo;
-	tabla_mutex[pos].estado = UNLOCKED;
-	tabla_mutex[pos].n_blocks = 0;
-	tabla_mutex[pos].procesos_esperando.primero = NULL;
-	tabla_mutex[pos].procesos_esperando.ultimo = NULL;
-	tabla_mutex[pos].n_opens = 1;
-	n_mutex_open++;
+int sis_leer()
+{
+	return leer_con_plazo((char *)leer_registro(1), (int)leer_registro(2), ESPERA_INDEFINIDA);
+}
 
-	// le asignamos la posicion de la tabla al descriptor libre del proceso actual
-	p_proc_actual->desc_mutex[descriptor] = pos;
+int sis_leer_timeout()
+{
+	char *buf;
+	int n, ticks;
 
-	return pos;
+	buf = (char *)leer_registro(1);
+	n = (int)leer_registro(2);
+	ticks = (int)leer_registro(3);
+	return leer_con_plazo(buf, n, ticks > 0 ? ticks : 0);
 }
 
-int sis_abrir_mutex()
+/* Cambia el modo de entrada del terminal: TERM_CARACTER o TERM_LINEA */
+int sis_fijar_modo_terminal()
 {
-	int descr, mutexid;
-	char *nombre;
+	int modo, nivel_previo;
 
-	// miramos si al proceso actual le quedan descriptores de mutex libres
-	descr = get_free_mutex_descrp();
-	if (descr == -1)
-	{
-		printk("ERROR: proceso actual no tiene descriptores de mutex libres.\n");
+	modo = (int)leer_registro(1);
+	if (modo != TERM_CARACTER && modo != TERM_LINEA)
 		return -1;
-	}
 
-	nombre = (char *)leer_registro(1);
-	mutexid = buscar_nombre_mutex(nombre);
-	if (mutexid == -1)
+	nivel_previo = fijar_nivel_int(NIVEL_2);
+	modoTerminal = modo;
+
+	// al pasar a modo caracter se puede leer ya la linea que estuviera a medias
+	if (modo == TERM_CARACTER && contDisponibles < contCaracteres)
 	{
-		printk("ERROR: no existe mutex con ese nombre.\n");
-		return -1;
+		contDisponibles = contCaracteres;
+		desbloquear_todos(&lista_bloq_lectura);
+		despertar_eventos(1, NULL);
 	}
-
-	// se asocia el descriptor del proceso al mutex correspondiente
-	p_proc_actual->desc_mutex[descr] = mutexid;
-	tabla_mutex[mutexid].n_opens++;
-
-	return mutexid;
+	fijar_nivel_int(nivel_previo);
+	return 0;
 }
 
-int sis_lock()
+/*
+ * Espera a que se produzca cualquiera de los eventos indicados: que haya
+ * caracteres en el terminal o que quede libre alguno de los mutex. No coge
+ * nada, solo marca los eventos que se han producido y devuelve cuantos son.
+ * Con un plazo 0 solo los consulta y con uno negativo espera sin limite;
+ * si vence el plazo devuelve 0
+ */
+int sis_esperar_eventos()
 {
-	unsigned int mutexid, found;
-	int nivel_previo;
-	mutex *mut;
-	BCP *proc_a_bloquear;
-	mutexid = (unsigned int)leer_registro(1);
+	evento *eventos_usr, eventos[MAX_EVENTOS];
+	mutex *mut_evento[MAX_EVENTOS], *muts[MAX_EVENTOS];
+	int n, ticks, i, n_muts, listos, nivel_previo;
+
+	eventos_usr = (evento *)leer_registro(1);
+	n = (int)leer_registro(2);
+	ticks = (int)leer_registro(3);
 
-	// primero mira si el proceso ha abierto el mutex anteriormente
-	found = find_mutex_descrp(mutexid);
-	if (found == -1)
+	if (n <= 0 || n > MAX_EVENTOS)
 	{
-		printk("ERROR: el proceso no ha abierto el mutex %d.\n", mutexid);
+		printk_error("ERROR: numero de eventos %d no valido.\n", n);
 		return -1;
 	}
 
-	// obtenemos la información del mutex
-	mut = &tabla_mutex[mutexid];
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	for (i = 0; i < n; i++)
+		eventos[i] = eventos_usr[i];
+	acceso_parametro = 0;
 
-	// miramos si esta libre el mutex
-	while (mut->estado == LOCKED)
+	p_proc_actual->eventos_terminal = 0;
+	n_muts = 0;
+	for (i = 0; i < n; i++)
 	{
-
-		// miramos si el proceso actual ya es propietario del mutex
-		if (mut->owner == p_proc_actual->id)
+		mut_evento[i] = NULL;
+		if (eventos[i].tipo == EVENTO_TERMINAL)
+			p_proc_actual->eventos_terminal = 1;
+		else if (eventos[i].tipo == EVENTO_MUTEX)
 		{
-			// comprobamos qua tipo de mutex es
-			if (mut->tipo == RECURSIVO)
-			{
-				mut->n_blocks++; // proceso vuelve a bloquear el mutex
-				return 0;
-			}
-			else
+			mut_evento[i] = obtener_mutex(eventos[i].id);
+			if (mut_evento[i] == NULL)
 			{
-				printk("ERROR: el proceso ya es propietario del mutex no recursivo %d.\n", mutexid);
+				printk_error("ERROR: el proceso no ha abierto el mutex %d.\n", eventos[i].id);
 				return -1;
 			}
+			muts[n_muts++] = mut_evento[i];
 		}
-		else // si no es propietario y no lo puede coger se bloquea el proceso
+		else
 		{
-			nivel_previo = fijar_nivel_int(3);
+			printk_error("ERROR: tipo de evento %d no valido.\n", eventos[i].tipo);
+			return -1;
+		}
+	}
+	// el vector vive en esta pila mientras el proceso esta bloqueado
+	p_proc_actual->eventos_mutex = muts;
+	p_proc_actual->n_eventos_mutex = n_muts;
 
-			p_proc_actual->estado = BLOQUEADO;
-			proc_a_bloquear = p_proc_actual;
-			// sacamos el proceso actual de la lista de listos
-			eliminar_elem(&lista_listos, p_proc_actual);
+	p_proc_actual->ticks_plazo = ticks > 0 ? ticks : 0;
+	p_proc_actual->plazo_vencido = 0;
 
-			// insertamos proceso bloqueado en la lista de procesos esperando al mutex
-			insertar_ultimo(&mut->procesos_esperando, p_proc_actual);
+	// que no lleguen caracteres entre la comprobacion y el bloqueo
+	nivel_previo = fijar_nivel_int(NIVEL_2);
+	for (;;)
+	{
+		listos = 0;
+		for (i = 0; i < n; i++)
+		{
+			if (mut_evento[i] == NULL)
+				eventos[i].listo = contDisponibles > 0;
+			else
+				eventos[i].listo = mut_evento[i]->compartido.palabra == 0;
+			listos += eventos[i].listo;
+		}
+		if (listos > 0 || ticks == 0 || p_proc_actual->plazo_vencido)
+			break;
 
-			fijar_nivel_int(nivel_previo);
+		// asi los propietarios entraran al kernel al soltarlos
+		for (i = 0; i < n_muts; i++)
+			muts[i]->compartido.palabra |= MUTEX_ESPERANDO;
 
-			// siguiente proceso
-			p_proc_actual = planificador();
-			cambio_contexto(&proc_a_bloquear->contexto_regs, &p_proc_actual->contexto_regs);
-		}
+		bloquear_proceso_actual(&lista_bloq_eventos);
 	}
+	fijar_nivel_int(nivel_previo);
 
-	// cuando este libre lo bloquea
-	mut->estado = LOCKED;
-	mut->owner = p_proc_actual->id;
-	mut->n_blocks++;
-	return 0;
+	p_proc_actual->ticks_plazo = 0;
+	p_proc_actual->eventos_terminal = 0;
+	p_proc_actual->eventos_mutex = NULL;
+	p_proc_actual->n_eventos_mutex = 0;
+
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	for (i = 0; i < n; i++)
+		eventos_usr[i].listo = eventos[i].listo;
+	acceso_parametro = 0;
+	return listos;
 }
 
-int sis_unlock()
+/* Deja en la zona de usuario los contadores de la entrada del terminal */
+int sis_leer_estad_terminal()
 {
-	unsigned int mutexid, found;
-	mutex *mut;
-	mutexid = (unsigned int)leer_registro(1);
+	estad_terminal *estad;
+	int nivel_previo;
 
-	// primero mira si el proceso ha abierto el mutex anteriormente
-	found = find_mutex_descrp(mutexid);
-	if (found == -1)
-	{
-		printk("ERROR: el proceso no ha abierto el mutex %d.\n", mutexid);
-		return -1;
-	}
+	estad = (estad_terminal *)leer_registro(1);
 
-	// obtenemos la información del mutex
-	mut = &tabla_mutex[mutexid];
+	// se toma una copia coherente sin que lleguen caracteres entre medias
+	nivel_previo = fijar_nivel_int(NIVEL_2);
+	estad_term.tam_buffer = TAM_BUF_TERM;
+	estad_term.pendientes = contCaracteres;
 
-	// comprueba que el mutex esta bloqueado
-	if (mut->estado != LOCKED)
-	{
-		printk("ERROR: el mutex %d no esta bloqueado.\n", mutexid);
-		return -1;
-	}
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	*estad = estad_term;
+	acceso_parametro = 0;
+	fijar_nivel_int(nivel_previo);
+	return 0;
+}
 
-	// comprueba que el proceso actual tiene bloqueado el mutex
-	if (mut->owner != p_proc_actual->id)
-	{
-		printk("ERROR: el mutex %d no esta bloqueado por el proceso actual.\n", mutexid);
+/*
+ * Copia en la zona de usuario los ultimos sucesos de la traza, como mucho
+ * max, del mas antiguo al mas reciente. Devuelve cuantos ha copiado
+ */
+int sis_leer_traza()
+{
+	suceso_traza *sucesos;
+	int max, n, i;
+	unsigned long primero;
+
+	sucesos = (suceso_traza *)leer_registro(1);
+	max = (int)leer_registro(2);
+	if (max <= 0)
 		return -1;
-	}
 
-	// restamos 1 al contador de bloqueos
-	mut->n_blocks--;
+	n = n_sucesos < TAM_TRAZA ? n_sucesos : TAM_TRAZA;
+	if (n > max)
+		n = max;
+	primero = n_sucesos - n;
+
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	for (i = 0; i < n; i++)
+		sucesos[i] = traza[(primero + i) % TAM_TRAZA];
+	acceso_parametro = 0;
+	return n;
+}
 
-	// si el proceso actual ha hecho el mismo nº de locks que unlocks
-	if (mut->n_blocks == 0)
-	{
-		mut->estado = UNLOCKED;
-		mut->owner = -1;
+/* Fija el nivel de los mensajes del kernel que se escriben y devuelve el anterior */
+int sis_fijar_nivel_log()
+{
+	int nivel, anterior;
 
-		// desbloqueamos al primer proceso esperando por el mutex si lo hay
-		desbloquear_proc_esperando(&mut->procesos_esperando);
+	nivel = (int)leer_registro(1);
+	if (nivel < LOG_ERROR || nivel > LOG_TRAZA)
+	{
+		printk_error("ERROR: nivel de mensajes %d no valido.\n", nivel);
+		return -1;
 	}
-
-	return 0;
+	anterior = nivel_log;
+	nivel_log = nivel;
+	return anterior;
 }
 
-int sis_cerrar_mutex()
+/* Rutina que fija la prioridad base del proceso actual */
+int sis_fijar_prioridad()
 {
-	unsigned int mutexid;
-	int descpr;
-	mutex *mut;
-	mutexid = (unsigned int)leer_registro(1);
+	int prioridad;
 
-	// primero mira si el proceso ha abierto el mutex anteriormente
-	descpr = find_mutex_descrp(mutexid);
-	if (descpr == -1)
+	prioridad = (int)leer_registro(1);
+	if (prioridad < 0 || prioridad > MAX_PRIORIDAD)
 	{
-		printk("ERROR: el proceso no ha abierto el mutex %d.\n", mutexid);
+		printk_error("ERROR: prioridad %d fuera de rango.\n", prioridad);
 		return -1;
 	}
 
-	// obtenemos la información del mutex
-	mut = &tabla_mutex[mutexid];
+	p_proc_actual->prioridad_base = prioridad;
+	// la efectiva no baja de la heredada de los mutex que tenga
+	p_proc_actual->prioridad = -1;
+	recalcular_prioridad(p_proc_actual);
+	return 0;
+}
 
-	// eliminamos y cerramos mutex de la lista de descriptores del proceso actual
-	while (descpr != -1)
-	{
-		p_proc_actual->desc_mutex[descpr] = -1;
-		mut->n_opens--;
-		descpr = find_mutex_descrp(mutexid);
-	}
+/* direccion de la pagina de usuario, para uso interno de la biblioteca */
 
-	// si ademas el proceso actual tiene bloqueado el mutex
-	if (mut->owner == p_proc_actual->id && mut->estado == LOCKED)
-	{
-		mut->estado = UNLOCKED;
-		mut->n_blocks = 0; // cerramos todas las veces que se habia bloqueado por el proceso actual
-		// desbloqueamos procesos esperando por el mutex
-		desbloquear_proc_esperando(&mut->procesos_esperando);
-	}
+int sis_pagina_usuario()
+{
+	pagina_usuario **dir;
 
-	// si no hay nadie con el mutex abierto se elimina definitivamente
-	if (mut->n_opens <= 0)
-	{
-		mut->estado = SIN_USAR;
-		n_mutex_open--;
+	dir = (pagina_usuario **)leer_registro(1);
 
-		// desbloqueamos procesos esperando a crear un mutex si los habia
-		desbloquear_proc_esperando(&lista_bloq_mutex);
-	}
+	// controlamos acceso por si hay excepción
+	acceso_parametro = 1;
+	*dir = &pagina_usr;
+	acceso_parametro = 0;
 
 	return 0;
 }
 
-/* entrada por teclado */
+/* estadisticas de las secciones con interrupciones inhabilitadas */
 
-int sis_leer_caracter()
+int sis_volcar_estad_int()
 {
-	int nivel_previo, caracter;
-	BCP *proc_bloqueado;
+	int i, reiniciar;
+	estad_int *e;
 
-	// inhibilitamos interrupciones de nivel 2 para que no lleguen caracteres entre medias
-	nivel_previo = fijar_nivel_int(NIVEL_2);
+	reiniciar = (int)leer_registro(1);
 
-	// mientras no haya caracteres por leer se bloquea
-	while (contCaracteres == 0)
+	printk("-> SECCIONES CON INTERRUPCIONES INHABILITADAS (ns)\n");
+	for (i = 0; i < n_sitios_int; i++)
 	{
-		p_proc_actual->estado = BLOQUEADO;
-		// quitamos todas las interrupciones
-		fijar_nivel_int(NIVEL_3);
-		eliminar_elem(&lista_listos, p_proc_actual);
-		insertar_ultimo(&lista_bloq_lectura, p_proc_actual);
-		// activamos interrupciones anteriores
-		fijar_nivel_int(NIVEL_2);
+		e = &tabla_estad_int[i];
+		printk("%s:%d veces %lu total %llu max %llu media %llu\n",
+			   e->funcion, e->linea, e->veces, e->total_ns, e->max_ns,
+			   e->veces ? e->total_ns / e->veces : 0ULL);
 
-		proc_bloqueado = p_proc_actual;
-		// siguiente proceso
-		p_proc_actual = planificador();
-		cambio_contexto(&proc_bloqueado->contexto_regs, &p_proc_actual->contexto_regs);
+		if (reiniciar)
+		{
+			e->veces = 0;
+			e->total_ns = 0;
+			e->max_ns = 0;
+		}
 	}
 
-	caracter = sacar_primer_caracter();
-
-	// volvemos a activar interrupciones
-	fijar_nivel_int(nivel_previo);
-
-	return caracter;
+	return 0;
 }
 
 /****************************************************************************************
@@ -985,6 +4002,14 @@ int main()
 
 	iniciar_tabla_proc();  /* inicia BCPs de tabla de procesos */
 	iniciar_tabla_mutex(); /* inicia tabla de mutex del sistema */
+	iniciar_tabla_rwlock(); /* inicia tabla de cerrojos del sistema */
+	iniciar_tabla_sem();	/* inicia tabla de semaforos del sistema */
+	iniciar_tabla_cond();	/* inicia tabla de variables condicion */
+	iniciar_tabla_barrera(); /* inicia tabla de barreras */
+	iniciar_tabla_contador(); /* inicia tabla de contadores */
+	iniciar_tabla_tuberia(); /* inicia tabla de tuberias */
+	iniciar_tabla_memoria(); /* inicia tabla de memoria compartida */
+	iniciar_tabla_buzon(); /* inicia tabla de buzones */
 
 	/* crea proceso inicial */
 	if (crear_tarea((void *)"init") < 0)
@@ -35,17 +35,16 @@ int main(){
 	if (abrir_mutex("m4")<0)
 		printf("error abriendo m4. NO DEBE SALIR\n");
 
-	/* Error: ha agotado los descriptores */
+	/* Correcto: un proceso puede tener abiertos hasta NUM_DESC_PROC */
 	if (abrir_mutex("m5")<0)
-		printf("error abriendo m5. DEBE SALIR\n");
+		printf("error abriendo m5. NO DEBE SALIR\n");
 
 	/* libera un descriptor de mutex (m1) */
 	cerrar_mutex(desc);
 
-	/* Agotado num mutex del sistema. Debe bloquearse */
+	/* Correcto: lleno el primer bloque de la tabla de mutex, se amplia */
 	if (crear_mutex("m17", 0)<0)
 		printf("error creando m17. NO DEBE SALIR\n");
-	/* se desbloquear cuando se elimine m1 */
 
 	/* intenta crear el mismo mutex: devuelve un error porque ya existe */
 	if (crear_mutex("m17", 0)<0)
@@ -0,0 +1,39 @@
+/*
+ * usuario/acaparador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba del limite de mutex:
+ * crea 32 mutex y los mantiene abiertos 2 segundos
+ */
+
+#include "servicios.h"
+
+int main(){
+	char nombre[8];
+	int i, id;
+
+	id=obtener_id_pr();
+	printf("acaparador %d: crea 32 mutex\n", id);
+
+	/* nombre distinto por proceso: a<id>_<i> */
+	nombre[0]='a';
+	nombre[1]='0'+id;
+	nombre[2]='_';
+	nombre[5]='\0';
+	for (i=0; i<32; i++) {
+		nombre[3]='0'+i/10;
+		nombre[4]='0'+i%10;
+		if (crear_mutex(nombre, NO_RECURSIVO)<0)
+			printf("error creando %s. NO DEBE SALIR\n", nombre);
+	}
+
+	dormir(2);
+	printf("acaparador %d: termina\n", id);
+	return 0;
+}
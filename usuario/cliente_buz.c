@@ -0,0 +1,43 @@
+/*
+ * usuario/cliente_buz.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que recibe los mensajes del buzon buz de prueba_buzon
+ * y le responde por el buzon resp si han llegado todos en orden
+ */
+
+#include "servicios.h"
+
+#define MENSAJES 8 /* igual que en prueba_buzon */
+
+int main(){
+	char msg[TAM_MENSAJE], *texto;
+	int buz, resp, i, desordenados=0;
+
+	if ((buz=abrir_buzon("buz"))<0)
+		printf("error abriendo buz. NO DEBE APARECER\n");
+	resp=abrir_buzon("resp");
+
+	for (i=0; i<MENSAJES; i++) {
+		if (recibir_mensaje(buz, msg)<0)
+			printf("error recibiendo. NO DEBE APARECER\n");
+		if (msg[0]!=i)
+			desordenados++;
+	}
+
+	texto=desordenados ? "mensajes desordenados" : "todos en orden";
+	for (i=0; texto[i]; i++)
+		msg[i]=texto[i];
+	msg[i]='\0';
+	enviar_mensaje(resp, msg);
+
+	cerrar_buzon(buz);
+	cerrar_buzon(resp);
+	return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ * usuario/consumidor.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de semaforos:
+ * consume los datos que produce prueba_sem
+ */
+
+#include "servicios.h"
+
+int main(){
+	int datos, i;
+
+	if ((datos=abrir_sem("datos"))<0)
+		printf("error abriendo datos. NO DEBE APARECER\n");
+
+	for (i=0; i<3; i++) {
+		if (wait_sem(datos)<0)
+			printf("error en wait_sem. NO DEBE APARECER\n");
+		printf("consumidor: recibe dato %d\n", i);
+	}
+
+	printf("consumidor: termina\n");
+	return 0;
+}
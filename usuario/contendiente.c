@@ -0,0 +1,31 @@
+/*
+ * usuario/contendiente.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de contencion:
+ * coge repetidamente el mutex mcon durante unos ticks
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mc, i, t0;
+
+	if ((mc=abrir_mutex("mcon"))<0)
+		printf("error abriendo mcon. NO DEBE APARECER\n");
+
+	for (i=0; i<10; i++) {
+		lock(mc);
+		t0=tiempos_proceso(0);
+		while (tiempos_proceso(0)-t0 < 3)
+			;
+		unlock(mc);
+	}
+	return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * usuario/escritor_tub.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que escribe en la tuberia tub de prueba_tuberia en
+ * trozos mayores que lo que cabe en ella y despues la cierra
+ */
+
+#include "servicios.h"
+
+#define TOTAL 5000 /* igual que en prueba_tuberia */
+#define TROZO 700
+
+int main(){
+	char buf[TROZO];
+	int tub, i, n, escritos=0;
+
+	if ((tub=abrir_tuberia("tub", TUB_ESCRITURA))<0)
+		printf("error abriendo tub. NO DEBE APARECER\n");
+
+	while (escritos<TOTAL) {
+		n=TOTAL-escritos<TROZO ? TOTAL-escritos : TROZO;
+		for (i=0; i<n; i++)
+			buf[i]=(escritos+i)%251;
+		if (escribir_tuberia(tub, buf, n)!=n)
+			printf("escritura incompleta. NO DEBE APARECER\n");
+		escritos+=n;
+	}
+	printf("escritor_tub: escritos %d bytes, cierra la tuberia\n", escritos);
+	cerrar_tuberia(tub);
+	return 0;
+}
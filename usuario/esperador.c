@@ -0,0 +1,36 @@
+/*
+ * usuario/esperador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de variables
+ * condicion: espera en cc con el mutex mc
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mc, cc;
+
+	if ((mc=abrir_mutex("mc"))<0)
+		printf("error abriendo mc. NO DEBE APARECER\n");
+
+	if ((cc=abrir_cond("cc"))<0)
+		printf("error abriendo cc. NO DEBE APARECER\n");
+
+	lock(mc);
+	printf("esperador: espera en cc\n");
+	if (wait_cond(cc, mc)<0)
+		printf("error en wait_cond. NO DEBE APARECER\n");
+
+	printf("esperador: despierta con mc cogido\n");
+	unlock(mc);
+
+	printf("esperador: termina\n");
+	return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * usuario/herencia_alta.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de herencia de
+ * prioridad: proceso de prioridad alta que espera por el mutex
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc;
+
+	fijar_prioridad(3);
+
+	if ((desc=abrir_mutex("mh"))<0)
+		printf("error abriendo mh. NO DEBE APARECER\n");
+
+	dormir(2);
+
+	/* se bloquea y herencia_baja pasa a ejecutar con su prioridad */
+	printf("herencia_alta: pide mh\n");
+	if (lock(desc)<0)
+		printf("error en lock de mutex. NO DEBE APARECER\n");
+
+	printf("herencia_alta: obtiene mh\n");
+	if (unlock(desc)<0)
+		printf("error en unlock de mutex. NO DEBE APARECER\n");
+
+	printf("herencia_alta: termina\n");
+	return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * usuario/herencia_baja.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de herencia de
+ * prioridad: proceso de prioridad baja que tiene el mutex
+ */
+
+#include "servicios.h"
+
+int main(){
+	int desc, t0;
+
+	fijar_prioridad(1);
+
+	if ((desc=abrir_mutex("mh"))<0)
+		printf("error abriendo mh. NO DEBE APARECER\n");
+
+	if (lock(desc)<0)
+		printf("error en lock de mutex. NO DEBE APARECER\n");
+
+	printf("herencia_baja: tiene mh y duerme 1 seg.\n");
+	dormir(1);
+
+	/* no ejecutara mientras lo haga herencia_media, salvo que herede
+	   la prioridad de herencia_alta */
+	printf("herencia_baja: calcula medio segundo con mh\n");
+	t0=tiempos_proceso(0);
+	while (tiempos_proceso(0)-t0 < 50)
+		;
+
+	printf("herencia_baja: libera mh\n");
+	if (unlock(desc)<0)
+		printf("error en unlock de mutex. NO DEBE APARECER\n");
+
+	printf("herencia_baja: termina\n");
+	return 0;
+}
@@ -0,0 +1,30 @@
+/*
+ * usuario/herencia_media.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de herencia de
+ * prioridad: proceso de prioridad media que solo calcula
+ */
+
+#include "servicios.h"
+
+int main(){
+	int t0;
+
+	fijar_prioridad(2);
+	dormir(1);
+
+	printf("herencia_media: calcula 3 segs.\n");
+	t0=tiempos_proceso(0);
+	while (tiempos_proceso(0)-t0 < 300)
+		;
+
+	printf("herencia_media: termina. DEBE SALIR DESPUES DE QUE herencia_alta OBTENGA mh\n");
+	return 0;
+}
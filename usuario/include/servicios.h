@@ -26,6 +26,110 @@
 #define RECURSIVO 0
 #define NO_RECURSIVO 1
 
+/* Opcion que se puede sumar al tipo: al desbloquear el mutex se cede
+   directamente al primer proceso que espera por el */
+#define MUTEX_TRASPASO 2
+
+/* Opcion que se puede sumar al tipo: si se ha alcanzado el limite de mutex
+   del sistema crear_mutex devuelve un error en vez de bloquearse */
+#define MUTEX_SIN_ESPERA 4
+
+/* Opcion de creacion de cerrojos de lectores/escritores: los escritores
+   que esperan no dejan pasar a nuevos lectores */
+#define RW_PREFERENCIA_ESCRITOR 1
+
+/* Modos de entrada del terminal: en modo linea leer devuelve como mucho
+   una linea y el kernel trata el borrado del ultimo caracter */
+#define TERM_CARACTER 0
+#define TERM_LINEA 1
+
+/* Tipos de evento de esperar_eventos */
+#define EVENTO_TERMINAL 1 /* hay caracteres que leer */
+#define EVENTO_MUTEX 2 /* el mutex id esta libre */
+
+/* cada uno de los eventos por los que se espera; a la vuelta listo indica
+   si se ha producido */
+struct evento {
+    int tipo;
+    unsigned int id;
+    int listo;
+};
+
+/* Modos del buffer de salida de escribir (y de printf): se vuelca al
+   completar una linea, solo cuando se llena o en cada escritura. Ademas se
+   vacia antes de las llamadas que pueden bloquear al proceso y al terminar */
+#define SALIDA_LINEA 0
+#define SALIDA_COMPLETA 1
+#define SALIDA_SIN_BUFFER 2
+
+/* Extremo de la tuberia que se abre con crear_tuberia y abrir_tuberia */
+#define TUB_LECTURA 0
+#define TUB_ESCRITURA 1
+
+/* Tamano fijo de los mensajes de los buzones (igual que en el kernel) */
+#define TAM_MENSAJE 64
+
+/* Niveles de los mensajes del kernel para fijar_nivel_log: solo se
+   escriben los de nivel menor o igual que el fijado */
+#define LOG_ERROR 0
+#define LOG_AVISO 1
+#define LOG_INFO 2
+#define LOG_TRAZA 3
+
+/* Sucesos de la traza del kernel que devuelve leer_traza */
+#define TRAZA_CAMBIO 1 /* cambio de contexto de proc a dato */
+#define TRAZA_BLOQUEO 2 /* proc se bloquea */
+#define TRAZA_DESPERTAR 3 /* proc vuelve a estar listo */
+#define TRAZA_LLAMADA 4 /* proc entra en la llamada dato */
+#define TRAZA_FIN_LLAMADA 5 /* proc sale de la llamada dato */
+#define TRAZA_INT_RELOJ 6 /* interrupciones, con proc el proceso actual */
+#define TRAZA_INT_TERMINAL 7
+#define TRAZA_INT_SW 8
+#define TRAZA_COGER_MUTEX 9 /* proc coge en el kernel el mutex de id dato */
+#define TRAZA_SOLTAR_MUTEX 10 /* proc suelta en el kernel el mutex de id dato */
+
+struct suceso_traza {
+    unsigned long long instante; /* ns del reloj del host */
+    int tipo;
+    int proc; /* proceso al que se refiere, -1 si ninguno */
+    int dato;
+};
+
+/* tamaño suficiente para el nombre de cualquier objeto del kernel */
+#define MAX_NOMBRE 16
+
+/* estadisticas de uso de un mutex, con los tiempos en ticks de reloj */
+struct estad_mutex {
+    unsigned long adquisiciones; /* sin contar los bloqueos recursivos */
+    unsigned long con_espera; /* adquisiciones en las que hubo que esperar */
+    unsigned long espera_total;
+    unsigned long espera_max;
+    unsigned long posesion_total; /* tiempo que ha estado cogido */
+    unsigned long posesion_max;
+    int max_esperando; /* maximo de procesos esperando a la vez */
+};
+
+/* contadores de la entrada del terminal desde el arranque */
+struct estad_terminal {
+    unsigned long recibidos; /* caracteres que han llegado del terminal */
+    unsigned long consumidos; /* caracteres leidos por los procesos */
+    unsigned long perdidos; /* descartados por estar lleno el buffer */
+    int tam_buffer; /* capacidad del buffer del terminal */
+    int pendientes; /* caracteres en el buffer sin leer */
+};
+
+/* estadisticas de un buzon desde que se creo */
+struct estad_buzon {
+    unsigned long enviados;
+    unsigned long traspasos; /* enviados directamente a un receptor que esperaba */
+    unsigned long recibidos;
+    int max_ocupados; /* maximo de mensajes en cola a la vez */
+    unsigned long espera_envio; /* ticks bloqueados los emisores */
+    unsigned long espera_recepcion; /* ticks bloqueados los receptores */
+    int profundidad; /* mensajes que caben en la cola */
+    int ocupados; /* mensajes en cola sin recibir */
+};
+
 /* cuántas veces se ha interrumpido en modo usuario y cuántas en sistema */
 struct tiempos_ejec {
     int usuario;
@@ -34,6 +138,8 @@ struct tiempos_ejec {
 
 /* Funcion de biblioteca */
 int escribirf(const char *formato, ...);
+int fijar_modo_salida(int modo);
+int vaciar_salida();
 
 /* Llamadas al sistema proporcionadas */
 int crear_proceso(char *prog);
@@ -47,7 +153,67 @@ int abrir_mutex(char *nombre);
 int lock(unsigned int mutexid);
 int unlock(unsigned int mutexid);
 int cerrar_mutex(unsigned int mutexid);
+int trylock(unsigned int mutexid);
+int lock_timeout(unsigned int mutexid, int ticks);
+int lock_varios(unsigned int *mutexids, int n);
+int unlock_varios(unsigned int *mutexids, int n);
+int leer_estad_mutex(int pos, char *nombre, struct estad_mutex *estad);
 int leer_caracter();
+int leer_estad_terminal(struct estad_terminal *estad);
+int leer(char *buf, int n);
+int fijar_modo_terminal(int modo);
+int leer_timeout(char *buf, int n, int ticks);
+int leer_caracter_timeout(int ticks);
+int esperar_eventos(struct evento *eventos, int n, int ticks);
+int fijar_nivel_log(int nivel);
+int leer_traza(struct suceso_traza *sucesos, int max);
+int crear_tuberia(char *nombre, int modo);
+int abrir_tuberia(char *nombre, int modo);
+int leer_tuberia(unsigned int tubid, char *buf, int n);
+int escribir_tuberia(unsigned int tubid, char *buf, int n);
+int cerrar_tuberia(unsigned int tubid);
+int crear_memoria(char *nombre, int tam, void **dir);
+int asociar_memoria(char *nombre, void **dir);
+int desasociar_memoria(unsigned int memid);
+int destruir_memoria(char *nombre);
+int crear_buzon(char *nombre, int profundidad);
+int abrir_buzon(char *nombre);
+int enviar_mensaje(unsigned int buzid, char *msg);
+int enviar_mensaje_timeout(unsigned int buzid, char *msg, int ticks);
+int recibir_mensaje(unsigned int buzid, char *msg);
+int recibir_mensaje_timeout(unsigned int buzid, char *msg, int ticks);
+int cerrar_buzon(unsigned int buzid);
+int leer_estad_buzon(unsigned int buzid, struct estad_buzon *estad);
+int volcar_estad_int(int reiniciar);
+int fijar_prioridad(int prioridad);
+int crear_rwlock(char *nombre, int opciones);
+int abrir_rwlock(char *nombre);
+int lock_lectura(unsigned int rwid);
+int lock_escritura(unsigned int rwid);
+int unlock_rw(unsigned int rwid);
+int cerrar_rwlock(unsigned int rwid);
+int crear_sem(char *nombre, int valor);
+int abrir_sem(char *nombre);
+int wait_sem(unsigned int semid);
+int signal_sem(unsigned int semid);
+int cerrar_sem(unsigned int semid);
+int crear_cond(char *nombre);
+int abrir_cond(char *nombre);
+int wait_cond(unsigned int condid, unsigned int mutexid);
+int signal_cond(unsigned int condid);
+int broadcast_cond(unsigned int condid);
+int cerrar_cond(unsigned int condid);
+int crear_barrera(char *nombre, int participantes);
+int abrir_barrera(char *nombre);
+int barrera_esperar(unsigned int barid);
+int cerrar_barrera(unsigned int barid);
+int crear_contador(char *nombre, int valor);
+int abrir_contador(char *nombre);
+int contador_leer(unsigned int contid, int *valor);
+int contador_sumar(unsigned int contid, int incremento, int *anterior);
+int contador_cas(unsigned int contid, int esperado, int nuevo);
+int contador_esperar(unsigned int contid, int objetivo);
+int cerrar_contador(unsigned int contid);
 
 #endif /* SERVICIOS_H */
 
@@ -0,0 +1,31 @@
+/*
+ * usuario/info_mutex.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que muestra las estadisticas de contencion de
+ * todos los mutex del sistema. Los tiempos son ticks de reloj
+ */
+
+#include "servicios.h"
+
+int main(){
+	int pos, res;
+	char nombre[MAX_NOMBRE];
+	struct estad_mutex e;
+
+	printf("MUTEX     ADQUIS  CON ESPERA  ESPERA TOT/MAX  POSESION TOT/MAX  MAX ESPERANDO\n");
+	for (pos=0; (res=leer_estad_mutex(pos, nombre, &e))>=0; pos++) {
+		if (res==1)
+			continue;
+		printf("%-8s %7lu %11lu %9lu/%-5lu %11lu/%-5lu %14d\n", nombre,
+			e.adquisiciones, e.con_espera, e.espera_total, e.espera_max,
+			e.posesion_total, e.posesion_max, e.max_esperando);
+	}
+	return 0;
+}
@@ -89,6 +89,106 @@ ALGO COMENTE ESTA PARTE Y DESCOMENTE LA PRUEBA CORRESPONDIENTE
 		printf("Error creando prueba_term\n");
 /**/
 
+/* PRUEBA DE LA HERENCIA DE PRIORIDAD EN MUTEX
+	if (crear_proceso("prueba_herencia")<0)
+		printf("Error creando prueba_herencia\n");
+*/
+
+/* PRUEBA DE LOS CERROJOS DE LECTORES/ESCRITORES
+	if (crear_proceso("prueba_rwlock")<0)
+		printf("Error creando prueba_rwlock\n");
+*/
+
+/* PRUEBA DE SEMAFOROS Y VARIABLES CONDICION
+	if (crear_proceso("prueba_sem")<0)
+		printf("Error creando prueba_sem\n");
+*/
+
+/* PRUEBA DE TRYLOCK Y LOCK CON PLAZO
+	if (crear_proceso("prueba_trylock")<0)
+		printf("Error creando prueba_trylock\n");
+*/
+
+/* PRUEBA DE LOCK_VARIOS
+	if (crear_proceso("prueba_varios")<0)
+		printf("Error creando prueba_varios\n");
+*/
+
+/* PRUEBA DE LAS ESTADISTICAS DE CONTENCION DE MUTEX
+	if (crear_proceso("prueba_contencion")<0)
+		printf("Error creando prueba_contencion\n");
+*/
+
+/* PRUEBA DEL LIMITE DE MUTEX DEL SISTEMA
+	if (crear_proceso("prueba_limite_mutex")<0)
+		printf("Error creando prueba_limite_mutex\n");
+*/
+
+/* PRUEBA DE LAS BARRERAS
+	if (crear_proceso("prueba_barrera")<0)
+		printf("Error creando prueba_barrera\n");
+*/
+
+/* PRUEBA DE LOS CONTADORES
+	if (crear_proceso("prueba_contador")<0)
+		printf("Error creando prueba_contador\n");
+*/
+
+/* PRUEBA DEL BUFFER CIRCULAR DEL TERMINAL
+	if (crear_proceso("prueba_buffer_term")<0)
+		printf("Error creando prueba_buffer_term\n");
+*/
+
+/* PRUEBA DE LECTURA DE VARIOS CARACTERES Y MODO LINEA
+	if (crear_proceso("prueba_linea")<0)
+		printf("Error creando prueba_linea\n");
+*/
+
+/* PRUEBA DE LECTURAS DEL TERMINAL SIN ESPERA Y CON PLAZO
+	if (crear_proceso("prueba_leer_plazo")<0)
+		printf("Error creando prueba_leer_plazo\n");
+*/
+
+/* PRUEBA DE ESPERA POR VARIOS EVENTOS
+	if (crear_proceso("prueba_eventos")<0)
+		printf("Error creando prueba_eventos\n");
+*/
+
+/* PRUEBA DE LOS MODOS DEL BUFFER DE SALIDA
+	if (crear_proceso("prueba_salida")<0)
+		printf("Error creando prueba_salida\n");
+*/
+
+/* PRUEBA DE LOS NIVELES DE LOS MENSAJES DEL KERNEL
+	if (crear_proceso("prueba_log")<0)
+		printf("Error creando prueba_log\n");
+*/
+
+/* PRUEBA DE LA TRAZA DE SUCESOS DEL KERNEL
+	if (crear_proceso("prueba_traza")<0)
+		printf("Error creando prueba_traza\n");
+*/
+
+/* PRUEBA DE TUBERIAS
+	if (crear_proceso("prueba_tuberia")<0)
+		printf("Error creando prueba_tuberia\n");
+*/
+
+/* PRUEBA DE MEMORIA COMPARTIDA
+	if (crear_proceso("prueba_memoria")<0)
+		printf("Error creando prueba_memoria\n");
+*/
+
+/* PRUEBA DE BUZONES
+	if (crear_proceso("prueba_buzon")<0)
+		printf("Error creando prueba_buzon\n");
+*/
+
+/* PRUEBA DE NOMBRES DE LONGITUD MAXIMA
+	if (crear_proceso("prueba_nombre_max")<0)
+		printf("Error creando prueba_nombre_max\n");
+*/
+
 	printf("init: termina\n");
 	return 0; 
 }
@@ -0,0 +1,37 @@
+/*
+ * usuario/intentador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de trylock y
+ * lock_timeout: intenta coger mt mientras lo tiene prueba_trylock
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mt;
+
+	if ((mt=abrir_mutex("mt"))<0)
+		printf("error abriendo mt. NO DEBE APARECER\n");
+
+	if (trylock(mt)<0)
+		printf("intentador: trylock falla. DEBE APARECER\n");
+
+	if (lock_timeout(mt, 50)<0)
+		printf("intentador: lock_timeout de 50 ticks vence. DEBE APARECER\n");
+
+	if (lock_timeout(mt, 300)<0)
+		printf("intentador: lock_timeout de 300 ticks vence. NO DEBE APARECER\n");
+	else
+		printf("intentador: obtiene mt despues de que lo suelte prueba_trylock\n");
+
+	unlock(mt);
+	printf("intentador: termina\n");
+	return 0;
+}
@@ -26,6 +26,85 @@
 
 int llamsis(int llamada, int nargs, ... /* args */);
 
+/*
+ * Acceso directo a los mutex a traves de la pagina de usuario del kernel.
+ * Los procesos que ejecutan el mismo programa comparten las variables de
+ * la biblioteca, por eso solo se guarda aqui la direccion de la pagina,
+ * que es la misma para todos. El proceso en ejecucion se lee de ella.
+ */
+static pagina_usuario *pagina = NULL;
+
+static void obtener_pagina()
+{
+   if (pagina == NULL)
+      llamsis(PAGINA_USUARIO, 1, (long)&pagina);
+}
+
+/* parte compartida del mutex de un descriptor, NULL si no es un mutex */
+static mutex_usuario *mutex_de(unsigned int mutexid)
+{
+   if (pagina == NULL || mutexid >= NUM_DESC_PROC)
+      return NULL;
+   return pagina->mutex[pagina->id_actual][mutexid];
+}
+
+/* buffer de salida del proceso en ejecucion, tambien en la pagina para
+   que no lo compartan los procesos que ejecutan el mismo programa */
+static salida_usuario *salida_actual()
+{
+   obtener_pagina();
+   return &pagina->salida[pagina->id_actual];
+}
+
+/* anota en las estadisticas que el proceso acaba de coger el mutex libre.
+   Las estadisticas se actualizan de forma atomica porque tambien las
+   modifican el kernel y el que coja el mutex en cuanto se suelte */
+static void cogido(mutex_usuario *m)
+{
+   m->n_blocks = 1;
+   m->inicio_posesion = pagina->ticks;
+   __sync_fetch_and_add(&m->estad.adquisiciones, 1);
+}
+
+/* anota en las estadisticas que se ha soltado un mutex cogido en inicio */
+static void soltado(mutex_usuario *m, unsigned long inicio)
+{
+   unsigned long posesion = pagina->ticks - inicio;
+   unsigned long max;
+
+   __sync_fetch_and_add(&m->estad.posesion_total, posesion);
+   max = m->estad.posesion_max;
+   while (posesion > max &&
+          !__sync_bool_compare_and_swap(&m->estad.posesion_max, max, posesion))
+      max = m->estad.posesion_max;
+}
+
+/*
+ *
+ * Buffer de salida: escribir, y por tanto printf, acumula los caracteres y
+ * solo llama al sistema cuando toca segun el modo
+ *
+ */
+
+int fijar_modo_salida(int modo)
+{
+   if (modo != SALIDA_LINEA && modo != SALIDA_COMPLETA && modo != SALIDA_SIN_BUFFER)
+      return -1;
+   vaciar_salida();
+   salida_actual()->modo = modo;
+   return 0;
+}
+int vaciar_salida()
+{
+   salida_usuario *s = salida_actual();
+   int n = s->ocupados;
+
+   if (n == 0)
+      return 0;
+   s->ocupados = 0;
+   return llamsis(ESCRIBIR, 2, (long)s->datos, (long)n);
+}
+
 /*
  *
  * Funciones interfaz a las llamadas al sistema
@@ -34,15 +113,38 @@ int llamsis(int llamada, int nargs, ... /* args */);
 
 int crear_proceso(char *prog)
 {
+   vaciar_salida();
    return llamsis(CREAR_PROCESO, 1, (long)prog);
 }
 int terminar_proceso()
 {
+   vaciar_salida();
    return llamsis(TERMINAR_PROCESO, 0);
 }
 int escribir(char *texto, unsigned int longi)
 {
-   return llamsis(ESCRIBIR, 2, (long)texto, (long)longi);
+   salida_usuario *s = salida_actual();
+   unsigned int i;
+   int fin_linea = 0;
+
+   if (s->modo == SALIDA_SIN_BUFFER)
+      return llamsis(ESCRIBIR, 2, (long)texto, (long)longi);
+
+   /* si no cabe se vacia antes, y si tampoco cabria vacio se escribe tal cual */
+   if (s->ocupados + longi > TAM_BUF_SALIDA)
+   {
+      vaciar_salida();
+      if (longi > TAM_BUF_SALIDA)
+         return llamsis(ESCRIBIR, 2, (long)texto, (long)longi);
+   }
+   for (i = 0; i < longi; i++)
+   {
+      s->datos[s->ocupados++] = texto[i];
+      fin_linea |= texto[i] == '\n';
+   }
+   if (fin_linea && s->modo == SALIDA_LINEA)
+      vaciar_salida();
+   return 0;
 }
 int obtener_id_pr()
 {
@@ -50,6 +152,7 @@ int obtener_id_pr()
 }
 int dormir(unsigned int s)
 {
+   vaciar_salida();
    return llamsis(DORMIR, 1, (long)s);
 }
 int tiempos_proceso(struct tiempos_ejec *t_ejec)
@@ -58,28 +161,394 @@ int tiempos_proceso(struct tiempos_ejec *t_ejec)
 }
 int crear_mutex(char *nombre, int tipo)
 {
+   obtener_pagina();
+   vaciar_salida();
    return llamsis(CREAR_MUTEX, 2, (long)nombre, (long)tipo);
 }
 int abrir_mutex(char *nombre)
 {
+   obtener_pagina();
    return llamsis(ABRIR_MUTEX, 1, (long)nombre);
 }
 
+/* Si el mutex esta libre, o es recursivo y ya es nuestro, no se llama al
+   sistema. En otro caso el kernel bloquea al proceso o informa del error */
 int lock(unsigned int mutexid)
 {
+   mutex_usuario *m;
+   unsigned int yo;
+
+   m = mutex_de(mutexid);
+   if (m != NULL)
+   {
+      yo = pagina->id_actual + 1;
+      if (__sync_bool_compare_and_swap(&m->palabra, 0, yo))
+      {
+         cogido(m);
+         return 0;
+      }
+      if ((m->palabra & ~MUTEX_ESPERANDO) == yo && m->tipo == RECURSIVO)
+      {
+         m->n_blocks++;
+         return 0;
+      }
+   }
+   vaciar_salida();
    return llamsis(LOCK, 1, (long)mutexid);
 }
 
+/* Como lock, pero si el mutex es de otro proceso devuelve -1 sin esperar */
+int trylock(unsigned int mutexid)
+{
+   mutex_usuario *m;
+   unsigned int yo;
+
+   m = mutex_de(mutexid);
+   if (m != NULL)
+   {
+      yo = pagina->id_actual + 1;
+      if (__sync_bool_compare_and_swap(&m->palabra, 0, yo))
+      {
+         cogido(m);
+         return 0;
+      }
+      if ((m->palabra & ~MUTEX_ESPERANDO) != yo)
+         return -1;
+      if (m->tipo == RECURSIVO)
+      {
+         m->n_blocks++;
+         return 0;
+      }
+   }
+   return llamsis(TRYLOCK, 1, (long)mutexid);
+}
+
+/* Como lock, pero el kernel deja de esperar tras el plazo en ticks de reloj */
+int lock_timeout(unsigned int mutexid, int ticks)
+{
+   mutex_usuario *m;
+   unsigned int yo;
+
+   m = mutex_de(mutexid);
+   if (m != NULL)
+   {
+      yo = pagina->id_actual + 1;
+      if (__sync_bool_compare_and_swap(&m->palabra, 0, yo))
+      {
+         cogido(m);
+         return 0;
+      }
+      if ((m->palabra & ~MUTEX_ESPERANDO) == yo && m->tipo == RECURSIVO)
+      {
+         m->n_blocks++;
+         return 0;
+      }
+   }
+   vaciar_salida();
+   return llamsis(LOCK_TIMEOUT, 2, (long)mutexid, (long)ticks);
+}
+
+/* Solo se llama al sistema si hay procesos esperando por el mutex o si
+   el proceso no es su propietario (error) */
 int unlock(unsigned int mutexid)
 {
+   mutex_usuario *m;
+   unsigned int yo;
+   unsigned long inicio;
+
+   m = mutex_de(mutexid);
+   if (m != NULL)
+   {
+      yo = pagina->id_actual + 1;
+      if ((m->palabra & ~MUTEX_ESPERANDO) == yo)
+      {
+         if (m->n_blocks > 1)
+         {
+            m->n_blocks--;
+            return 0;
+         }
+         m->n_blocks = 0;
+         inicio = m->inicio_posesion;
+         if (__sync_bool_compare_and_swap(&m->palabra, yo, 0))
+         {
+            soltado(m, inicio);
+            return 0;
+         }
+         /* hay procesos esperando: lo libera el kernel */
+         m->n_blocks = 1;
+      }
+   }
    return llamsis(UNLOCK, 1, (long)mutexid);
 }
 
+int lock_varios(unsigned int *mutexids, int n)
+{
+   vaciar_salida();
+   return llamsis(LOCK_VARIOS, 2, (long)mutexids, (long)n);
+}
+int unlock_varios(unsigned int *mutexids, int n)
+{
+   return llamsis(UNLOCK_VARIOS, 2, (long)mutexids, (long)n);
+}
+int leer_estad_mutex(int pos, char *nombre, struct estad_mutex *estad)
+{
+   return llamsis(LEER_ESTAD_MUTEX, 3, (long)pos, (long)nombre, (long)estad);
+}
 int cerrar_mutex(unsigned int mutexid)
 {
    return llamsis(CERRAR_MUTEX, 1, (long)mutexid);
 }
 int leer_caracter()
 {
+   vaciar_salida();
    return llamsis(LEER_CARACTER, 0);
-}
\ No newline at end of file
+}
+int fijar_prioridad(int prioridad)
+{
+   return llamsis(FIJAR_PRIORIDAD, 1, (long)prioridad);
+}
+int crear_rwlock(char *nombre, int opciones)
+{
+   return llamsis(CREAR_RWLOCK, 2, (long)nombre, (long)opciones);
+}
+int abrir_rwlock(char *nombre)
+{
+   return llamsis(ABRIR_RWLOCK, 1, (long)nombre);
+}
+int lock_lectura(unsigned int rwid)
+{
+   vaciar_salida();
+   return llamsis(LOCK_LECTURA, 1, (long)rwid);
+}
+int lock_escritura(unsigned int rwid)
+{
+   vaciar_salida();
+   return llamsis(LOCK_ESCRITURA, 1, (long)rwid);
+}
+int unlock_rw(unsigned int rwid)
+{
+   return llamsis(UNLOCK_RW, 1, (long)rwid);
+}
+int cerrar_rwlock(unsigned int rwid)
+{
+   return llamsis(CERRAR_RWLOCK, 1, (long)rwid);
+}
+int crear_sem(char *nombre, int valor)
+{
+   return llamsis(CREAR_SEM, 2, (long)nombre, (long)valor);
+}
+int abrir_sem(char *nombre)
+{
+   return llamsis(ABRIR_SEM, 1, (long)nombre);
+}
+int wait_sem(unsigned int semid)
+{
+   vaciar_salida();
+   return llamsis(WAIT_SEM, 1, (long)semid);
+}
+int signal_sem(unsigned int semid)
+{
+   return llamsis(SIGNAL_SEM, 1, (long)semid);
+}
+int cerrar_sem(unsigned int semid)
+{
+   return llamsis(CERRAR_SEM, 1, (long)semid);
+}
+int crear_cond(char *nombre)
+{
+   return llamsis(CREAR_COND, 1, (long)nombre);
+}
+int abrir_cond(char *nombre)
+{
+   return llamsis(ABRIR_COND, 1, (long)nombre);
+}
+int wait_cond(unsigned int condid, unsigned int mutexid)
+{
+   vaciar_salida();
+   return llamsis(WAIT_COND, 2, (long)condid, (long)mutexid);
+}
+int signal_cond(unsigned int condid)
+{
+   return llamsis(SIGNAL_COND, 1, (long)condid);
+}
+int broadcast_cond(unsigned int condid)
+{
+   return llamsis(BROADCAST_COND, 1, (long)condid);
+}
+int cerrar_cond(unsigned int condid)
+{
+   return llamsis(CERRAR_COND, 1, (long)condid);
+}
+int crear_barrera(char *nombre, int participantes)
+{
+   return llamsis(CREAR_BARRERA, 2, (long)nombre, (long)participantes);
+}
+int abrir_barrera(char *nombre)
+{
+   return llamsis(ABRIR_BARRERA, 1, (long)nombre);
+}
+int barrera_esperar(unsigned int barid)
+{
+   vaciar_salida();
+   return llamsis(BARRERA_ESPERAR, 1, (long)barid);
+}
+int cerrar_barrera(unsigned int barid)
+{
+   return llamsis(CERRAR_BARRERA, 1, (long)barid);
+}
+int crear_contador(char *nombre, int valor)
+{
+   return llamsis(CREAR_CONTADOR, 2, (long)nombre, (long)valor);
+}
+int abrir_contador(char *nombre)
+{
+   return llamsis(ABRIR_CONTADOR, 1, (long)nombre);
+}
+int contador_leer(unsigned int contid, int *valor)
+{
+   return llamsis(CONTADOR_LEER, 2, (long)contid, (long)valor);
+}
+int contador_sumar(unsigned int contid, int incremento, int *anterior)
+{
+   return llamsis(CONTADOR_SUMAR, 3, (long)contid, (long)incremento, (long)anterior);
+}
+int contador_cas(unsigned int contid, int esperado, int nuevo)
+{
+   return llamsis(CONTADOR_CAS, 3, (long)contid, (long)esperado, (long)nuevo);
+}
+int contador_esperar(unsigned int contid, int objetivo)
+{
+   vaciar_salida();
+   return llamsis(CONTADOR_ESPERAR, 2, (long)contid, (long)objetivo);
+}
+int cerrar_contador(unsigned int contid)
+{
+   return llamsis(CERRAR_CONTADOR, 1, (long)contid);
+}
+int leer_estad_terminal(struct estad_terminal *estad)
+{
+   return llamsis(LEER_ESTAD_TERMINAL, 1, (long)estad);
+}
+int leer(char *buf, int n)
+{
+   vaciar_salida();
+   return llamsis(LEER, 2, (long)buf, (long)n);
+}
+int fijar_modo_terminal(int modo)
+{
+   return llamsis(FIJAR_MODO_TERMINAL, 1, (long)modo);
+}
+/* Como leer, pero devuelve -1 si no llega nada en el plazo en ticks de
+   reloj. Con un plazo 0 no se bloquea nunca */
+int leer_timeout(char *buf, int n, int ticks)
+{
+   vaciar_salida();
+   return llamsis(LEER_TIMEOUT, 3, (long)buf, (long)n, (long)ticks);
+}
+int leer_caracter_timeout(int ticks)
+{
+   char car;
+
+   if (leer_timeout(&car, 1, ticks) < 0)
+      return -1;
+   return (unsigned char)car;
+}
+/* Espera a que se produzca alguno de los eventos, como mucho ticks de
+   reloj (0 solo consulta, negativo sin limite). Devuelve cuantos hay */
+int esperar_eventos(struct evento *eventos, int n, int ticks)
+{
+   vaciar_salida();
+   return llamsis(ESPERAR_EVENTOS, 3, (long)eventos, (long)n, (long)ticks);
+}
+int fijar_nivel_log(int nivel)
+{
+   return llamsis(FIJAR_NIVEL_LOG, 1, (long)nivel);
+}
+int leer_traza(struct suceso_traza *sucesos, int max)
+{
+   return llamsis(LEER_TRAZA, 2, (long)sucesos, (long)max);
+}
+int crear_tuberia(char *nombre, int modo)
+{
+   return llamsis(CREAR_TUBERIA, 2, (long)nombre, (long)modo);
+}
+int abrir_tuberia(char *nombre, int modo)
+{
+   return llamsis(ABRIR_TUBERIA, 2, (long)nombre, (long)modo);
+}
+/* Devuelve los bytes leidos, que pueden ser menos de n, y 0 al llegar al
+   final, cuando se ha cerrado el ultimo extremo de escritura */
+int leer_tuberia(unsigned int tubid, char *buf, int n)
+{
+   vaciar_salida();
+   return llamsis(LEER_TUBERIA, 3, (long)tubid, (long)buf, (long)n);
+}
+/* Solo escribe menos de n bytes si se cierra el ultimo extremo de lectura */
+int escribir_tuberia(unsigned int tubid, char *buf, int n)
+{
+   vaciar_salida();
+   return llamsis(ESCRIBIR_TUBERIA, 3, (long)tubid, (long)buf, (long)n);
+}
+int cerrar_tuberia(unsigned int tubid)
+{
+   return llamsis(CERRAR_TUBERIA, 1, (long)tubid);
+}
+/* Crea un segmento de tam bytes a cero y deja en dir su direccion */
+int crear_memoria(char *nombre, int tam, void **dir)
+{
+   return llamsis(CREAR_MEMORIA, 3, (long)nombre, (long)tam, (long)dir);
+}
+int asociar_memoria(char *nombre, void **dir)
+{
+   return llamsis(ASOCIAR_MEMORIA, 2, (long)nombre, (long)dir);
+}
+/* Despues de desasociarse no se debe seguir usando la zona */
+int desasociar_memoria(unsigned int memid)
+{
+   return llamsis(DESASOCIAR_MEMORIA, 1, (long)memid);
+}
+int destruir_memoria(char *nombre)
+{
+   return llamsis(DESTRUIR_MEMORIA, 1, (long)nombre);
+}
+int crear_buzon(char *nombre, int profundidad)
+{
+   return llamsis(CREAR_BUZON, 2, (long)nombre, (long)profundidad);
+}
+int abrir_buzon(char *nombre)
+{
+   return llamsis(ABRIR_BUZON, 1, (long)nombre);
+}
+/* Los mensajes son siempre de TAM_MENSAJE bytes */
+int enviar_mensaje(unsigned int buzid, char *msg)
+{
+   return enviar_mensaje_timeout(buzid, msg, -1);
+}
+/* Como enviar_mensaje, pero devuelve -1 si el buzon sigue lleno pasado el
+   plazo en ticks de reloj. Con un plazo 0 no se bloquea nunca */
+int enviar_mensaje_timeout(unsigned int buzid, char *msg, int ticks)
+{
+   vaciar_salida();
+   return llamsis(ENVIAR_MENSAJE, 3, (long)buzid, (long)msg, (long)ticks);
+}
+int recibir_mensaje(unsigned int buzid, char *msg)
+{
+   return recibir_mensaje_timeout(buzid, msg, -1);
+}
+int recibir_mensaje_timeout(unsigned int buzid, char *msg, int ticks)
+{
+   vaciar_salida();
+   return llamsis(RECIBIR_MENSAJE, 3, (long)buzid, (long)msg, (long)ticks);
+}
+int cerrar_buzon(unsigned int buzid)
+{
+   return llamsis(CERRAR_BUZON, 1, (long)buzid);
+}
+int leer_estad_buzon(unsigned int buzid, struct estad_buzon *estad)
+{
+   return llamsis(LEER_ESTAD_BUZON, 2, (long)buzid, (long)estad);
+}
+int volcar_estad_int(int reiniciar)
+{
+   return llamsis(VOLCAR_ESTAD_INT, 1, (long)reiniciar);
+}
@@ -0,0 +1,31 @@
+/*
+ * usuario/ocupador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de esperar_eventos:
+ * coge el mutex mev durante 2 segundos
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mev;
+
+	if ((mev=abrir_mutex("mev"))<0)
+		printf("error abriendo mev. NO DEBE APARECER\n");
+
+	lock(mev);
+	printf("ocupador: coge mev y duerme 2 segundos\n");
+	dormir(2);
+	printf("ocupador: suelta mev\n");
+	unlock(mev);
+
+	printf("ocupador: termina\n");
+	return 0;
+}
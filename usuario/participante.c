@@ -0,0 +1,35 @@
+/*
+ * usuario/participante.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de barreras: en cada
+ * fase calcula un tiempo que depende de su identificador
+ */
+
+#include "servicios.h"
+
+int main(){
+	int bar, fase, id, t0;
+
+	if ((bar=abrir_barrera("fase"))<0)
+		printf("error abriendo fase. NO DEBE APARECER\n");
+
+	id=obtener_id_pr();
+	for (fase=0; fase<3; fase++) {
+		t0=tiempos_proceso(0);
+		while (tiempos_proceso(0)-t0 < 20*id)
+			;
+		printf("participante %d: llega a la fase %d\n", id, fase);
+		if (barrera_esperar(bar)==1)
+			printf("participante %d: es el ultimo en llegar a la fase %d\n", id, fase);
+	}
+
+	printf("participante %d: termina\n", id);
+	return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * usuario/prueba_barrera.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de las barreras: tres
+ * procesos avanzan por fases y ninguno empieza una fase hasta que todos
+ * han terminado la anterior
+ */
+
+#include "servicios.h"
+
+int main(){
+	int bar, fase;
+
+	printf("prueba_barrera: comienza\n");
+
+	if ((bar=crear_barrera("fase", 3))<0)
+		printf("error creando fase. NO DEBE APARECER\n");
+
+	if (crear_barrera("otra", 0)<0)
+		printf("error creando barrera sin participantes. DEBE APARECER\n");
+
+	if (crear_proceso("participante")<0)
+		printf("Error creando participante\n");
+
+	if (crear_proceso("participante")<0)
+		printf("Error creando participante\n");
+
+	for (fase=0; fase<3; fase++) {
+		printf("prueba_barrera: llega a la fase %d\n", fase);
+		if (barrera_esperar(bar)<0)
+			printf("error en barrera_esperar. NO DEBE APARECER\n");
+		printf("prueba_barrera: pasa la fase %d\n", fase);
+	}
+
+	printf("prueba_barrera: termina\n");
+	return 0;
+}
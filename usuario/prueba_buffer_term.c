@@ -0,0 +1,46 @@
+/*
+ * usuario/prueba_buffer_term.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba el buffer circular del terminal: se
+ * duerme mientras se teclea para que se llene y luego lo vacia,
+ * mostrando los contadores de caracteres recibidos, leidos y perdidos
+ */
+
+#include "servicios.h"
+
+static void mostrar(void){
+	struct estad_terminal e;
+
+	leer_estad_terminal(&e);
+	printf("prueba_buffer_term: buffer %d pendientes %d recibidos %lu consumidos %lu perdidos %lu\n",
+		e.tam_buffer, e.pendientes, e.recibidos, e.consumidos, e.perdidos);
+}
+
+int main(){
+	int i, n;
+	struct estad_terminal e;
+
+	printf("prueba_buffer_term: comienza (teclee mas caracteres que el tamano del buffer)\n");
+	mostrar();
+
+	dormir(4);
+	mostrar();
+
+	leer_estad_terminal(&e);
+	n = e.pendientes;
+	printf("prueba_buffer_term: leidos ");
+	for (i=0; i<n; i++)
+		printf("%c", leer_caracter());
+	printf("\n");
+	mostrar();
+
+	printf("prueba_buffer_term: termina\n");
+	return 0;
+}
@@ -0,0 +1,77 @@
+/*
+ * usuario/prueba_buzon.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los buzones: envio y recepcion sin espera
+ * y con plazo, llenado de la cola, traspaso directo a cliente_buz cuando
+ * ya esta esperando y estadisticas
+ */
+
+#include "servicios.h"
+
+#define PROFUNDIDAD 4
+#define MENSAJES 8 /* igual que en cliente_buz */
+
+int main(){
+	char msg[TAM_MENSAJE];
+	struct estad_buzon estad;
+	int buz, resp, i;
+
+	printf("prueba_buzon: comienza\n");
+
+	if ((buz=crear_buzon("buz", PROFUNDIDAD))<0)
+		printf("error creando buz. NO DEBE APARECER\n");
+	if ((resp=crear_buzon("resp", 1))<0)
+		printf("error creando resp. NO DEBE APARECER\n");
+	if (crear_buzon("otro", 100)>=0)
+		printf("buzon demasiado profundo. NO DEBE APARECER\n");
+
+	if (recibir_mensaje_timeout(buz, msg, 0)>=0)
+		printf("recibido de buzon vacio. NO DEBE APARECER\n");
+	if (recibir_mensaje_timeout(buz, msg, 5)>=0)
+		printf("recibido de buzon vacio con plazo. NO DEBE APARECER\n");
+
+	/* llena la cola */
+	for (i=0; i<PROFUNDIDAD; i++) {
+		msg[0]=i;
+		if (enviar_mensaje_timeout(buz, msg, 0)<0)
+			printf("error enviando %d. NO DEBE APARECER\n", i);
+	}
+	if (enviar_mensaje_timeout(buz, msg, 0)>=0)
+		printf("enviado a buzon lleno. NO DEBE APARECER\n");
+	if (enviar_mensaje_timeout(buz, msg, 5)>=0)
+		printf("enviado a buzon lleno con plazo. NO DEBE APARECER\n");
+	printf("prueba_buzon: cola llena con %d mensajes\n", PROFUNDIDAD);
+
+	if (crear_proceso("cliente_buz")<0)
+		printf("Error creando cliente_buz\n");
+
+	/* cliente_buz vacia la cola y se queda esperando */
+	dormir(1);
+	for (; i<MENSAJES; i++) {
+		msg[0]=i;
+		enviar_mensaje(buz, msg);
+	}
+
+	recibir_mensaje(resp, msg);
+	printf("prueba_buzon: respuesta: %s\n", msg);
+
+	leer_estad_buzon(buz, &estad);
+	printf("prueba_buzon: enviados %lu recibidos %lu max_ocupados %d ocupados %d\n",
+		estad.enviados, estad.recibidos, estad.max_ocupados, estad.ocupados);
+	if (estad.traspasos==0)
+		printf("ningun traspaso directo. NO DEBE APARECER\n");
+	if (estad.espera_recepcion==0)
+		printf("cliente_buz no ha esperado. NO DEBE APARECER\n");
+
+	cerrar_buzon(resp);
+	cerrar_buzon(buz);
+	printf("prueba_buzon: termina\n");
+	return 0;
+}
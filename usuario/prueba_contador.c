@@ -0,0 +1,50 @@
+/*
+ * usuario/prueba_contador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los contadores: reparto
+ * de tickets, espera hasta completar el trabajo y compare-and-swap
+ */
+
+#include "servicios.h"
+
+int main(){
+	int tickets, hechos, valor;
+
+	printf("prueba_contador: comienza\n");
+
+	if ((tickets=crear_contador("tickets", 0))<0)
+		printf("error creando tickets. NO DEBE APARECER\n");
+
+	if ((hechos=crear_contador("hechos", 0))<0)
+		printf("error creando hechos. NO DEBE APARECER\n");
+
+	if (crear_proceso("trabajador")<0)
+		printf("Error creando trabajador\n");
+
+	if (crear_proceso("trabajador")<0)
+		printf("Error creando trabajador\n");
+
+	/* se bloquea hasta que los trabajadores completan los 6 tickets */
+	if (contador_esperar(hechos, 6)<0)
+		printf("error en contador_esperar. NO DEBE APARECER\n");
+	printf("prueba_contador: completados los 6 tickets\n");
+
+	if (contador_cas(tickets, 6, 100)!=1)
+		printf("error en contador_cas. NO DEBE APARECER\n");
+
+	if (contador_cas(tickets, 6, 0)==0)
+		printf("contador_cas con valor distinto no lo cambia. DEBE APARECER\n");
+
+	contador_leer(tickets, &valor);
+	printf("prueba_contador: tickets vale %d. DEBE SER 100\n", valor);
+
+	printf("prueba_contador: termina\n");
+	return 0;
+}
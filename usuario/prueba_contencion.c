@@ -0,0 +1,47 @@
+/*
+ * usuario/prueba_contencion.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que provoca contencion en un mutex y muestra sus
+ * estadisticas con info_mutex
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mc, i, t0;
+
+	printf("prueba_contencion: comienza\n");
+
+	if ((mc=crear_mutex("mcon", NO_RECURSIVO))<0)
+		printf("error creando mcon. NO DEBE APARECER\n");
+
+	if (crear_mutex("libre", NO_RECURSIVO)<0)
+		printf("error creando libre. NO DEBE APARECER\n");
+
+	for (i=0; i<2; i++)
+		if (crear_proceso("contendiente")<0)
+			printf("Error creando contendiente\n");
+
+	/* este proceso no espera nunca, ya que coge mcon sin contencion */
+	lock(mc);
+	t0=tiempos_proceso(0);
+	while (tiempos_proceso(0)-t0 < 20)
+		;
+	unlock(mc);
+
+	dormir(3);
+	if (crear_proceso("info_mutex")<0)
+		printf("Error creando info_mutex\n");
+
+	/* mantiene abiertos los mutex mientras se muestran */
+	dormir(1);
+	printf("prueba_contencion: termina\n");
+	return 0;
+}
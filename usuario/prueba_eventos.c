@@ -0,0 +1,61 @@
+/*
+ * usuario/prueba_eventos.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba esperar_eventos: espera a la vez por el
+ * terminal y por un mutex que tiene cogido ocupador
+ */
+
+#include "servicios.h"
+
+int main(){
+	struct evento ev[2];
+	char buf[32];
+	int mev, n;
+
+	printf("prueba_eventos: comienza\n");
+
+	if ((mev=crear_mutex("mev", NO_RECURSIVO))<0)
+		printf("error creando mev. NO DEBE APARECER\n");
+	if (crear_proceso("ocupador")<0)
+		printf("Error creando ocupador\n");
+
+	/* deja que ocupador coja el mutex */
+	dormir(1);
+
+	ev[0].tipo=EVENTO_MUTEX;
+	ev[0].id=mev;
+	n=esperar_eventos(ev, 1, 0);
+	printf("prueba_eventos: consulta sin espera del mutex devuelve %d\n", n);
+
+	n=esperar_eventos(ev, 1, 30);
+	printf("prueba_eventos: espera de 30 ticks por el mutex devuelve %d\n", n);
+
+	ev[1].tipo=EVENTO_TERMINAL;
+	printf("prueba_eventos: espera sin limite por el mutex y el terminal\n");
+	while ((n=esperar_eventos(ev, 2, -1))>0) {
+		if (ev[1].listo) {
+			n=leer(buf, sizeof(buf)-1);
+			buf[n]='\0';
+			printf("prueba_eventos: terminal listo, leidos %d caracteres: %s\n", n, buf);
+		}
+		if (ev[0].listo) {
+			printf("prueba_eventos: mutex listo\n");
+			if (trylock(mev)==0) {
+				printf("prueba_eventos: coge mev\n");
+				unlock(mev);
+			}
+			break;
+		}
+	}
+
+	cerrar_mutex(mev);
+	printf("prueba_eventos: termina\n");
+	return 0;
+}
@@ -0,0 +1,38 @@
+/*
+ * usuario/prueba_herencia.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de la herencia de prioridad
+ * en los mutex
+ */
+
+#include "servicios.h"
+
+int main(){
+
+	printf("prueba_herencia: comienza\n");
+
+	if (crear_mutex("mh", NO_RECURSIVO)<0)
+		printf("error creando mh. NO DEBE APARECER\n");
+
+	if (crear_proceso("herencia_baja")<0)
+		printf("Error creando herencia_baja\n");
+
+	if (crear_proceso("herencia_media")<0)
+		printf("Error creando herencia_media\n");
+
+	if (crear_proceso("herencia_alta")<0)
+		printf("Error creando herencia_alta\n");
+
+	/* mantiene abierto mh hasta que lo abran los demas */
+	dormir(1);
+
+	printf("prueba_herencia: termina\n");
+	return 0;
+}
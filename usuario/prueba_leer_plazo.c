@@ -0,0 +1,46 @@
+/*
+ * usuario/prueba_leer_plazo.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las lecturas del terminal sin espera y
+ * con plazo: consulta el terminal mientras hace otro trabajo y luego
+ * espera un plazo que vence y otro en el que llegan caracteres
+ */
+
+#include "servicios.h"
+
+int main(){
+	char buf[32];
+	int car, n, vueltas=0;
+
+	printf("prueba_leer_plazo: comienza\n");
+
+	car=leer_caracter_timeout(0);
+	printf("prueba_leer_plazo: lectura sin espera devuelve %d\n", car);
+
+	n=leer_timeout(buf, sizeof(buf)-1, 20);
+	printf("prueba_leer_plazo: lectura con plazo de 20 ticks devuelve %d\n", n);
+
+	printf("prueba_leer_plazo: teclee algo; mientras, sigue trabajando\n");
+	while ((car=leer_caracter_timeout(0))<0)
+		vueltas++;
+	printf("prueba_leer_plazo: tras %s vueltas de trabajo ha llegado %c\n",
+		vueltas>0 ? "varias" : "0", car);
+
+	n=leer_timeout(buf, sizeof(buf)-1, 300);
+	if (n>0) {
+		buf[n]='\0';
+		printf("prueba_leer_plazo: lectura con plazo de 300 ticks devuelve %d: %s\n", n, buf);
+	}
+	else
+		printf("prueba_leer_plazo: lectura con plazo de 300 ticks devuelve %d\n", n);
+
+	printf("prueba_leer_plazo: termina\n");
+	return 0;
+}
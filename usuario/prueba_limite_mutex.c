@@ -0,0 +1,40 @@
+/*
+ * usuario/prueba_limite_mutex.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la creacion de mutex al alcanzar el
+ * limite del sistema (MAX_MUT = 64), con y sin la opcion MUTEX_SIN_ESPERA
+ */
+
+#include "servicios.h"
+
+int main(){
+
+	printf("prueba_limite_mutex: comienza\n");
+
+	/* cada acaparador crea 32 mutex: entre los dos llenan la tabla */
+	if (crear_proceso("acaparador")<0)
+		printf("Error creando acaparador\n");
+
+	if (crear_proceso("acaparador")<0)
+		printf("Error creando acaparador\n");
+
+	dormir(1);
+
+	if (crear_mutex("extra", NO_RECURSIVO|MUTEX_SIN_ESPERA)<0)
+		printf("error creando extra sin esperar. DEBE SALIR\n");
+
+	/* se bloquea hasta que termine un acaparador */
+	printf("prueba_limite_mutex: crea extra esperando\n");
+	if (crear_mutex("extra", NO_RECURSIVO)<0)
+		printf("error creando extra. NO DEBE SALIR\n");
+
+	printf("prueba_limite_mutex: termina\n");
+	return 0;
+}
@@ -0,0 +1,42 @@
+/*
+ * usuario/prueba_linea.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la lectura de varios caracteres de una
+ * vez: primero lee lineas en modo linea, en el que el kernel trata el
+ * borrado, hasta que se teclea "fin" y luego lee en modo caracter todo
+ * lo que se haya tecleado mientras dormia
+ */
+
+#include "servicios.h"
+
+int main(){
+	char buf[32];
+	int n;
+
+	printf("prueba_linea: comienza en modo linea (teclee lineas, \"fin\" para acabar)\n");
+	fijar_modo_terminal(TERM_LINEA);
+
+	do {
+		n=leer(buf, sizeof(buf)-1);
+		buf[n]='\0';
+		printf("prueba_linea: leidos %d caracteres: %s", n, buf);
+	} while (n!=4 || buf[0]!='f' || buf[1]!='i' || buf[2]!='n');
+
+	printf("prueba_linea: pasa a modo caracter y duerme 2 segundos\n");
+	fijar_modo_terminal(TERM_CARACTER);
+	dormir(2);
+
+	n=leer(buf, sizeof(buf)-1);
+	buf[n]='\0';
+	printf("prueba_linea: leidos %d caracteres de una vez: %s\n", n, buf);
+
+	printf("prueba_linea: termina\n");
+	return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * usuario/prueba_log.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los niveles de los mensajes del kernel:
+ * sin traza no deben aparecer mensajes de interrupciones mientras duerme,
+ * y solo con errores tampoco los de creacion y fin de simplon
+ */
+
+#include "servicios.h"
+
+int main(){
+	int anterior;
+
+	printf("prueba_log: comienza\n");
+
+	anterior=fijar_nivel_log(LOG_INFO);
+	printf("prueba_log: nivel anterior %d; sin traza, duerme 1 segundo\n", anterior);
+	dormir(1);
+	if (crear_proceso("simplon")<0)
+		printf("Error creando simplon\n");
+	dormir(1);
+
+	fijar_nivel_log(LOG_ERROR);
+	printf("prueba_log: solo errores, crea simplon y da un error\n");
+	if (crear_proceso("simplon")<0)
+		printf("Error creando simplon\n");
+	dormir(1);
+	if (fijar_nivel_log(7)<0)
+		printf("prueba_log: nivel 7 rechazado\n");
+
+	fijar_nivel_log(LOG_TRAZA);
+	printf("prueba_log: vuelve a la traza completa\n");
+	dormir(1);
+
+	printf("prueba_log: termina\n");
+	return 0;
+}
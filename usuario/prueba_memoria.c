@@ -0,0 +1,69 @@
+/*
+ * usuario/prueba_memoria.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba la memoria compartida: dos procesos
+ * sumador_mem se asocian a un segmento y actualizan sus datos protegidos
+ * por un mutex, sin copiar nada a traves del kernel
+ */
+
+#include "servicios.h"
+
+#define VUELTAS 2000 /* igual que en sumador_mem */
+
+/* igual que en sumador_mem */
+struct compartida {
+	int total;
+	int vueltas[2];
+};
+
+int main(){
+	struct compartida *c, *otra;
+	int seg, seg2, mseg, hechos;
+
+	printf("prueba_memoria: comienza\n");
+
+	if ((seg=crear_memoria("seg", sizeof(struct compartida), (void **)&c))<0)
+		printf("error creando seg. NO DEBE APARECER\n");
+	if (c->total!=0)
+		printf("segmento no inicializado a cero. NO DEBE APARECER\n");
+	if ((mseg=crear_mutex("mseg", NO_RECURSIVO))<0)
+		printf("error creando mseg. NO DEBE APARECER\n");
+	if ((hechos=crear_contador("hechos", 0))<0)
+		printf("error creando hechos. NO DEBE APARECER\n");
+
+	if (crear_proceso("sumador_mem")<0)
+		printf("Error creando sumador_mem\n");
+	if (crear_proceso("sumador_mem")<0)
+		printf("Error creando sumador_mem\n");
+
+	/* los sumadores ya han terminado y se han desasociado */
+	contador_esperar(hechos, 2);
+	printf("prueba_memoria: total %d (vueltas %d y %d). DEBE SER %d\n",
+		c->total, c->vueltas[0], c->vueltas[1], 2*VUELTAS);
+
+	if ((seg2=asociar_memoria("seg", (void **)&otra))<0 || otra!=c)
+		printf("error asociandose de nuevo a seg. NO DEBE APARECER\n");
+
+	/* tras destruirlo sigue valido para los que estan asociados */
+	destruir_memoria("seg");
+	if (asociar_memoria("seg", (void **)&otra)>=0)
+		printf("asociado a seg destruido. NO DEBE APARECER\n");
+	c->total=0;
+	desasociar_memoria(seg);
+	if (desasociar_memoria(seg)>=0)
+		printf("desasociado dos veces. NO DEBE APARECER\n");
+	desasociar_memoria(seg2);
+
+	if (crear_memoria("grande", 2*1024*1024, (void **)&otra)>=0)
+		printf("segmento demasiado grande. NO DEBE APARECER\n");
+
+	printf("prueba_memoria: termina\n");
+	return 0;
+}
@@ -0,0 +1,53 @@
+/*
+ * usuario/prueba_nombre_max.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los nombres de la longitud maxima (8
+ * caracteres): se crean, se abren y se cierran, y al cerrarse del todo el
+ * nombre queda libre. Uno mas largo se rechaza
+ */
+
+#include "servicios.h"
+
+int main(){
+	int m1, m2, c1, c2, t;
+
+	printf("prueba_nombre_max: comienza\n");
+
+	if ((m1=crear_mutex("mutex_8c", NO_RECURSIVO))<0)
+		printf("error creando mutex_8c. NO DEBE APARECER\n");
+	if ((m2=abrir_mutex("mutex_8c"))<0)
+		printf("error abriendo mutex_8c. NO DEBE APARECER\n");
+	if (crear_mutex("mutex_8c", NO_RECURSIVO)>=0)
+		printf("mutex_8c creado dos veces. NO DEBE APARECER\n");
+	cerrar_mutex(m2);
+	cerrar_mutex(m1);
+	if (abrir_mutex("mutex_8c")>=0)
+		printf("mutex_8c sigue existiendo. NO DEBE APARECER\n");
+	if ((m1=crear_mutex("mutex_8c", NO_RECURSIVO))<0)
+		printf("error creando de nuevo mutex_8c. NO DEBE APARECER\n");
+	cerrar_mutex(m1);
+
+	if ((c1=crear_contador("cont_8cc", 5))<0)
+		printf("error creando cont_8cc. NO DEBE APARECER\n");
+	if ((c2=abrir_contador("cont_8cc"))<0)
+		printf("error abriendo cont_8cc. NO DEBE APARECER\n");
+	cerrar_contador(c1);
+	cerrar_contador(c2);
+	if (abrir_contador("cont_8cc")>=0)
+		printf("cont_8cc sigue existiendo. NO DEBE APARECER\n");
+
+	if ((t=crear_tuberia("nombre9cc", TUB_LECTURA))>=0) {
+		printf("creado nombre de 9 caracteres. NO DEBE APARECER\n");
+		cerrar_tuberia(t);
+	}
+
+	printf("prueba_nombre_max: termina\n");
+	return 0;
+}
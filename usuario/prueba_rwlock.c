@@ -0,0 +1,49 @@
+/*
+ * usuario/prueba_rwlock.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los cerrojos de
+ * lectores/escritores con preferencia de escritor
+ */
+
+#include "servicios.h"
+
+int main(){
+	int rw;
+
+	printf("prueba_rwlock: comienza\n");
+
+	if ((rw=crear_rwlock("rw", RW_PREFERENCIA_ESCRITOR))<0)
+		printf("error creando rw. NO DEBE APARECER\n");
+
+	if (lock_lectura(rw)<0)
+		printf("error en lock_lectura. NO DEBE APARECER\n");
+
+	/* el escritor se bloquea y, por la preferencia, el lector tambien */
+	if (crear_proceso("rw_escritor")<0)
+		printf("Error creando rw_escritor\n");
+
+	if (crear_proceso("rw_lector")<0)
+		printf("Error creando rw_lector\n");
+
+	dormir(1);
+	printf("prueba_rwlock: suelta el cerrojo de lectura\n");
+	if (unlock_rw(rw)<0)
+		printf("error en unlock_rw. NO DEBE APARECER\n");
+
+	/* Error: el descriptor ya no tiene cogido el cerrojo */
+	if (unlock_rw(rw)<0)
+		printf("error en unlock_rw. DEBE APARECER\n");
+
+	/* mantiene abierto rw hasta que terminen los demas */
+	dormir(3);
+
+	printf("prueba_rwlock: termina\n");
+	return 0;
+}
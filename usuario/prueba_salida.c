@@ -0,0 +1,50 @@
+/*
+ * usuario/prueba_salida.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba los modos del buffer de salida: compara
+ * el tiempo de sistema de escribir muchas lineas en modo linea y con el
+ * buffer completo, y comprueba que se vacia antes de dormir y al terminar
+ */
+
+#include "servicios.h"
+
+#define LINEAS 2000
+
+static void escribir_lineas(int modo, char *nombre) {
+	struct tiempos_ejec antes, despues;
+	int i;
+
+	fijar_modo_salida(modo);
+	tiempos_proceso(&antes);
+	for (i=0; i<LINEAS; i++)
+		printf("prueba_salida: linea %d\n", i);
+	vaciar_salida();
+	tiempos_proceso(&despues);
+
+	fijar_modo_salida(SALIDA_LINEA);
+	printf("prueba_salida: %d lineas en modo %s: ticks usuario %d sistema %d\n",
+		LINEAS, nombre, despues.usuario-antes.usuario,
+		despues.sistema-antes.sistema);
+}
+
+int main(){
+	printf("prueba_salida: comienza\n");
+
+	escribir_lineas(SALIDA_LINEA, "linea");
+	escribir_lineas(SALIDA_COMPLETA, "completo");
+	escribir_lineas(SALIDA_SIN_BUFFER, "sin buffer");
+
+	fijar_modo_salida(SALIDA_COMPLETA);
+	printf("prueba_salida: esto debe salir antes de dormir\n");
+	dormir(1);
+
+	printf("prueba_salida: termina sin vaciar la salida; debe salir igualmente\n");
+	return 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * usuario/prueba_sem.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de los semaforos y de las
+ * variables condicion
+ */
+
+#include "servicios.h"
+
+int main(){
+	int datos, mc, cc, i;
+
+	printf("prueba_sem: comienza\n");
+
+	if ((datos=crear_sem("datos", 0))<0)
+		printf("error creando datos. NO DEBE APARECER\n");
+
+	if (crear_sem("datos", 0)>=0)
+		printf("creado datos dos veces. NO DEBE APARECER\n");
+
+	if (crear_proceso("consumidor")<0)
+		printf("Error creando consumidor\n");
+
+	/* el consumidor solo avanza cuando hay datos */
+	for (i=0; i<3; i++) {
+		dormir(1);
+		printf("prueba_sem: produce dato %d\n", i);
+		if (signal_sem(datos)<0)
+			printf("error en signal_sem. NO DEBE APARECER\n");
+	}
+
+	if ((mc=crear_mutex("mc", NO_RECURSIVO))<0)
+		printf("error creando mc. NO DEBE APARECER\n");
+
+	if ((cc=crear_cond("cc"))<0)
+		printf("error creando cc. NO DEBE APARECER\n");
+
+	/* Error: hay que tener cogido el mutex */
+	if (wait_cond(cc, mc)<0)
+		printf("error en wait_cond sin mutex. DEBE APARECER\n");
+
+	if (crear_proceso("esperador")<0)
+		printf("Error creando esperador\n");
+
+	dormir(1);
+
+	/* el esperador ha soltado mc al esperar en cc */
+	lock(mc);
+	printf("prueba_sem: avisa por cc\n");
+	signal_cond(cc);
+	dormir(1);
+	printf("prueba_sem: suelta mc. esperador DEBE DESPERTAR AHORA\n");
+	unlock(mc);
+
+	dormir(1);
+	printf("prueba_sem: termina\n");
+	return 0;
+}
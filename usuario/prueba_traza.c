@@ -0,0 +1,36 @@
+/*
+ * usuario/prueba_traza.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que genera algo de actividad (dos procesos que
+ * gastan CPU y otro que duerme) y despues vuelca la traza del kernel en
+ * formato Chrome trace con traza_chrome
+ */
+
+#include "servicios.h"
+
+int main(){
+	printf("prueba_traza: comienza\n");
+
+	if (crear_proceso("mudo")<0)
+		printf("Error creando mudo\n");
+	if (crear_proceso("mudo")<0)
+		printf("Error creando mudo\n");
+	if (crear_proceso("dormilon")<0)
+		printf("Error creando dormilon\n");
+
+	dormir(3);
+
+	printf("prueba_traza: vuelca la traza\n");
+	if (crear_proceso("traza_chrome")<0)
+		printf("Error creando traza_chrome\n");
+
+	printf("prueba_traza: termina\n");
+	return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * usuario/prueba_trylock.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de trylock y lock_timeout
+ */
+
+#include "servicios.h"
+
+int main(){
+	int mt, m2;
+
+	printf("prueba_trylock: comienza\n");
+
+	if ((mt=crear_mutex("mt", NO_RECURSIVO))<0)
+		printf("error creando mt. NO DEBE APARECER\n");
+
+	if (trylock(mt)<0)
+		printf("error en trylock de mt libre. NO DEBE APARECER\n");
+
+	if (crear_proceso("intentador")<0)
+		printf("Error creando intentador\n");
+
+	/* intentador no lo consigue con trylock ni con un plazo corto */
+	dormir(1);
+	printf("prueba_trylock: suelta mt\n");
+	unlock(mt);
+
+	dormir(1);
+
+	/* cerrar otro descriptor del mismo mutex no lo suelta */
+	if ((m2=abrir_mutex("mt"))<0)
+		printf("error abriendo mt. NO DEBE APARECER\n");
+	lock(mt);
+	cerrar_mutex(m2);
+	if (unlock(mt)<0)
+		printf("mt soltado al cerrar otro descriptor. NO DEBE APARECER\n");
+
+	printf("prueba_trylock: termina\n");
+	return 0;
+}
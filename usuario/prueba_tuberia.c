@@ -0,0 +1,64 @@
+/*
+ * usuario/prueba_tuberia.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que prueba las tuberias: lee en trozos pequenos lo
+ * que escribe escritor_tub hasta el final y despues comprueba que escribir
+ * sin lectores falla
+ */
+
+#include "servicios.h"
+
+#define TOTAL 5000 /* igual que en escritor_tub */
+
+int main(){
+	char buf[100];
+	int tub, esc, n, i, total=0, errores=0, lecturas=0;
+
+	printf("prueba_tuberia: comienza\n");
+
+	if ((tub=crear_tuberia("tub", TUB_LECTURA))<0)
+		printf("error creando tub. NO DEBE APARECER\n");
+	if (crear_tuberia("tub", TUB_LECTURA)>=0)
+		printf("tub creada dos veces. NO DEBE APARECER\n");
+	if (crear_proceso("escritor_tub")<0)
+		printf("Error creando escritor_tub\n");
+
+	/* cada byte escrito es su posicion modulo 251 */
+	while ((n=leer_tuberia(tub, buf, sizeof(buf)))>0) {
+		for (i=0; i<n; i++)
+			if ((unsigned char)buf[i]!=(total+i)%251)
+				errores++;
+		total+=n;
+		lecturas++;
+	}
+	printf("prueba_tuberia: fin de datos (%d) tras %d bytes en %d lecturas con %d errores\n",
+		n, total, lecturas, errores);
+	if (total!=TOTAL || errores)
+		printf("datos recibidos incorrectos. NO DEBE APARECER\n");
+	cerrar_tuberia(tub);
+
+	/* ya no existe */
+	if (abrir_tuberia("tub", TUB_LECTURA)>=0)
+		printf("tub sigue existiendo. NO DEBE APARECER\n");
+
+	tub=crear_tuberia("rota", TUB_LECTURA);
+	esc=abrir_tuberia("rota", TUB_ESCRITURA);
+	n=escribir_tuberia(esc, buf, sizeof(buf));
+	printf("prueba_tuberia: escritura con lector devuelve %d\n", n);
+	if (leer_tuberia(esc, buf, sizeof(buf))>=0)
+		printf("leido del extremo de escritura. NO DEBE APARECER\n");
+	cerrar_tuberia(tub);
+	n=escribir_tuberia(esc, buf, sizeof(buf));
+	printf("prueba_tuberia: escritura sin lectores devuelve %d\n", n);
+	cerrar_tuberia(esc);
+
+	printf("prueba_tuberia: termina\n");
+	return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * usuario/prueba_varios.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que realiza una prueba de lock_varios y unlock_varios
+ */
+
+#include "servicios.h"
+
+int main(){
+	unsigned int m[2];
+	int i, t0;
+
+	printf("prueba_varios: comienza\n");
+
+	if ((m[0]=crear_mutex("ma", NO_RECURSIVO))<0)
+		printf("error creando ma. NO DEBE APARECER\n");
+
+	if ((m[1]=crear_mutex("mb", NO_RECURSIVO))<0)
+		printf("error creando mb. NO DEBE APARECER\n");
+
+	lock(m[0]);
+	if (crear_proceso("varios_hijo")<0)
+		printf("Error creando varios_hijo\n");
+	dormir(1);
+
+	/* varios_hijo espera por ma sin retener mb */
+	if (trylock(m[1])<0)
+		printf("prueba_varios: mb ocupado. NO DEBE APARECER\n");
+	else
+		printf("prueba_varios: mb libre mientras varios_hijo espera\n");
+	unlock(m[1]);
+	unlock(m[0]);
+
+	/* en orden contrario al del hijo, sin interbloqueos */
+	for (i=0; i<5; i++) {
+		if (lock_varios(m, 2)<0)
+			printf("error en lock_varios. NO DEBE APARECER\n");
+		t0=tiempos_proceso(0);
+		while (tiempos_proceso(0)-t0 < 5)
+			;
+		if (unlock_varios(m, 2)<0)
+			printf("error en unlock_varios. NO DEBE APARECER\n");
+	}
+
+	/* Error: mutex repetido */
+	m[1]=m[0];
+	if (lock_varios(m, 2)<0)
+		printf("error en lock_varios con repetidos. DEBE APARECER\n");
+
+	dormir(2);
+	printf("prueba_varios: termina\n");
+	return 0;
+}
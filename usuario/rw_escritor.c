@@ -0,0 +1,32 @@
+/*
+ * usuario/rw_escritor.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de cerrojos de
+ * lectores/escritores: escritor que espera a que salga el lector
+ */
+
+#include "servicios.h"
+
+int main(){
+	int rw;
+
+	if ((rw=abrir_rwlock("rw"))<0)
+		printf("error abriendo rw. NO DEBE APARECER\n");
+
+	printf("rw_escritor: intenta escribir\n");
+	if (lock_escritura(rw)<0)
+		printf("error en lock_escritura. NO DEBE APARECER\n");
+
+	printf("rw_escritor: escribiendo. DEBE SALIR ANTES QUE rw_lector LEA\n");
+	dormir(1);
+
+	printf("rw_escritor: termina sin soltar el cerrojo\n");
+	return 0;
+}
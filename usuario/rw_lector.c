@@ -0,0 +1,33 @@
+/*
+ * usuario/rw_lector.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de cerrojos de
+ * lectores/escritores: lector que llega cuando ya espera un escritor
+ */
+
+#include "servicios.h"
+
+int main(){
+	int rw;
+
+	if ((rw=abrir_rwlock("rw"))<0)
+		printf("error abriendo rw. NO DEBE APARECER\n");
+
+	printf("rw_lector: intenta leer\n");
+	if (lock_lectura(rw)<0)
+		printf("error en lock_lectura. NO DEBE APARECER\n");
+
+	printf("rw_lector: leyendo\n");
+	if (unlock_rw(rw)<0)
+		printf("error en unlock_rw. NO DEBE APARECER\n");
+
+	printf("rw_lector: termina\n");
+	return 0;
+}
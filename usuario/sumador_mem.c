@@ -0,0 +1,54 @@
+/*
+ * usuario/sumador_mem.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que se asocia al segmento seg de prueba_memoria y
+ * suma en el, cogiendo el mutex mseg en cada vuelta
+ */
+
+#include "servicios.h"
+
+#define VUELTAS 2000 /* igual que en prueba_memoria */
+
+/* igual que en prueba_memoria */
+struct compartida {
+	int total;
+	int vueltas[2];
+};
+
+int main(){
+	struct compartida *c;
+	int seg, mseg, hechos, yo, i;
+
+	if ((seg=asociar_memoria("seg", (void **)&c))<0)
+		printf("error asociandose a seg. NO DEBE APARECER\n");
+	mseg=abrir_mutex("mseg");
+	hechos=abrir_contador("hechos");
+
+	/* el primero que llega usa vueltas[0] */
+	lock(mseg);
+	yo=c->vueltas[0]>0;
+	c->vueltas[yo]++;
+	unlock(mseg);
+
+	for (i=1; i<VUELTAS; i++) {
+		lock(mseg);
+		c->total++;
+		c->vueltas[yo]++;
+		unlock(mseg);
+	}
+	lock(mseg);
+	c->total++;
+	unlock(mseg);
+
+	printf("sumador_mem %d: hecho\n", yo);
+	desasociar_memoria(seg);
+	contador_sumar(hechos, 1, 0);
+	return 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * usuario/trabajador.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de contadores: saca
+ * tres tickets y anota cada uno como hecho
+ */
+
+#include "servicios.h"
+
+int main(){
+	int tickets, hechos, i, n, id, t0;
+
+	if ((tickets=abrir_contador("tickets"))<0)
+		printf("error abriendo tickets. NO DEBE APARECER\n");
+
+	if ((hechos=abrir_contador("hechos"))<0)
+		printf("error abriendo hechos. NO DEBE APARECER\n");
+
+	id=obtener_id_pr();
+	for (i=0; i<3; i++) {
+		if (contador_sumar(tickets, 1, &n)<0)
+			printf("error en contador_sumar. NO DEBE APARECER\n");
+		printf("trabajador %d: atiende el ticket %d\n", id, n);
+		t0=tiempos_proceso(0);
+		while (tiempos_proceso(0)-t0 < 10)
+			;
+		contador_sumar(hechos, 1, 0);
+	}
+
+	printf("trabajador %d: termina\n", id);
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+ * usuario/traza_chrome.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que vuelca la traza de sucesos del kernel en el
+ * formato JSON de Chrome trace (chrome://tracing o Perfetto): por cada
+ * proceso, sus intervalos en ejecucion y sus llamadas al sistema, con
+ * bloqueos, despertares, mutex e interrupciones como sucesos puntuales.
+ * Mientras escribe deja solo los mensajes de error del kernel para que
+ * el JSON salga seguido
+ */
+
+#include "servicios.h"
+
+#define MAX_SUCESOS 4096 /* como TAM_TRAZA en el kernel */
+#define MAX_PROCS 64 /* mayor que MAX_PROC en el kernel */
+
+static struct suceso_traza sucesos[MAX_SUCESOS];
+
+static unsigned long long inicio; /* instante del primer suceso */
+static int hay_previo = 0; /* si ya se ha escrito algun suceso JSON */
+static int ejecutando[MAX_PROCS]; /* intervalo en ejecucion abierto */
+static int en_llamada[MAX_PROCS]; /* llamada abierta: numero + 1 */
+static int visto[MAX_PROCS]; /* si ya se ha nombrado el proceso */
+
+/* escribe la parte comun de un suceso JSON, sin cerrar la llave */
+static void cabecera(char *fase, const char *nombre, int num, int pid, int tid,
+		     unsigned long long instante) {
+	unsigned long long us = (instante - inicio) / 1000;
+
+	printf("%s\n{\"name\":\"%s", hay_previo ? "," : "", nombre);
+	if (num >= 0)
+		printf(" %d", num);
+	printf("\",\"ph\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%llu.%03llu",
+		fase, pid, tid, us, (instante - inicio) % 1000);
+	hay_previo = 1;
+}
+
+static void suceso(char *fase, const char *nombre, int num, int pid, int tid,
+		   unsigned long long instante) {
+	cabecera(fase, nombre, num, pid, tid, instante);
+	printf("}");
+}
+
+static void puntual(const char *nombre, int num, int tid, unsigned long long instante) {
+	cabecera("i", nombre, num, 1, tid, instante);
+	printf(",\"s\":\"t\"}");
+}
+
+/* da nombre al proceso en las dos pistas la primera vez que aparece */
+static void nombrar(int proc) {
+	int pid;
+
+	if (proc < 0 || proc >= MAX_PROCS || visto[proc])
+		return;
+	visto[proc] = 1;
+	for (pid = 1; pid <= 2; pid++) {
+		printf("%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,"
+			"\"args\":{\"name\":\"proceso %d\"}}", hay_previo ? "," : "",
+			pid, proc, proc);
+		hay_previo = 1;
+	}
+}
+
+static void fin_ejecucion(int proc, unsigned long long instante) {
+	if (proc >= 0 && proc < MAX_PROCS && ejecutando[proc]) {
+		suceso("E", "ejecucion", -1, 1, proc, instante);
+		ejecutando[proc] = 0;
+	}
+}
+
+static void fin_llamada(int proc, unsigned long long instante) {
+	if (proc >= 0 && proc < MAX_PROCS && en_llamada[proc]) {
+		suceso("E", "llamada", en_llamada[proc] - 1, 2, proc, instante);
+		en_llamada[proc] = 0;
+	}
+}
+
+int main(){
+	int n, i, p, nivel;
+	struct suceso_traza *s;
+
+	n = leer_traza(sucesos, MAX_SUCESOS);
+	if (n <= 0) {
+		printf("traza_chrome: no hay sucesos\n");
+		return 0;
+	}
+
+	nivel = fijar_nivel_log(LOG_ERROR);
+	fijar_modo_salida(SALIDA_COMPLETA);
+
+	inicio = sucesos[0].instante;
+	printf("{\"traceEvents\":[\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"procesos\"}},\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"llamadas al sistema\"}},\n"
+		"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":3,\"args\":{\"name\":\"interrupciones\"}}");
+	hay_previo = 1;
+
+	for (i = 0; i < n; i++) {
+		s = &sucesos[i];
+		if (s->proc >= MAX_PROCS)
+			continue;
+		nombrar(s->proc);
+
+		switch (s->tipo) {
+		case TRAZA_CAMBIO:
+			fin_ejecucion(s->proc, s->instante);
+			if (s->dato >= 0 && s->dato < MAX_PROCS) {
+				nombrar(s->dato);
+				suceso("B", "ejecucion", -1, 1, s->dato, s->instante);
+				ejecutando[s->dato] = 1;
+			}
+			break;
+		case TRAZA_BLOQUEO:
+			puntual("bloqueo", -1, s->proc, s->instante);
+			break;
+		case TRAZA_DESPERTAR:
+			puntual("despertar", -1, s->proc, s->instante);
+			break;
+		case TRAZA_LLAMADA:
+			/* si murio dentro de una llamada, esta no se cerro */
+			fin_llamada(s->proc, s->instante);
+			suceso("B", "llamada", s->dato, 2, s->proc, s->instante);
+			en_llamada[s->proc] = s->dato + 1;
+			break;
+		case TRAZA_FIN_LLAMADA:
+			fin_llamada(s->proc, s->instante);
+			break;
+		case TRAZA_INT_RELOJ:
+		case TRAZA_INT_TERMINAL:
+		case TRAZA_INT_SW:
+			cabecera("i", s->tipo == TRAZA_INT_RELOJ ? "reloj" :
+				s->tipo == TRAZA_INT_TERMINAL ? "terminal" : "int sw",
+				-1, 3, 0, s->instante);
+			printf(",\"s\":\"p\",\"args\":{\"proceso\":%d}}", s->proc);
+			break;
+		case TRAZA_COGER_MUTEX:
+			puntual("coge mutex", s->dato, s->proc, s->instante);
+			break;
+		case TRAZA_SOLTAR_MUTEX:
+			puntual("suelta mutex", s->dato, s->proc, s->instante);
+			break;
+		}
+	}
+
+	/* se cierra lo que siga abierto al final de la traza */
+	for (p = 0; p < MAX_PROCS; p++) {
+		fin_ejecucion(p, sucesos[n - 1].instante);
+		fin_llamada(p, sucesos[n - 1].instante);
+	}
+	printf("\n]}\n");
+
+	vaciar_salida();
+	fijar_nivel_log(nivel);
+	return 0;
+}
@@ -0,0 +1,39 @@
+/*
+ * usuario/varios_hijo.c
+ *
+ *  Minikernel. Version 1.0
+ *
+ *  Fernando Perez Costoya
+ *
+ */
+
+/*
+ * Programa de usuario que forma parte de la prueba de lock_varios:
+ * pide los mutex en orden contrario al de prueba_varios
+ */
+
+#include "servicios.h"
+
+int main(){
+	unsigned int m[2];
+	int i, t0;
+
+	if ((m[0]=abrir_mutex("mb"))<0)
+		printf("error abriendo mb. NO DEBE APARECER\n");
+
+	if ((m[1]=abrir_mutex("ma"))<0)
+		printf("error abriendo ma. NO DEBE APARECER\n");
+
+	for (i=0; i<5; i++) {
+		if (lock_varios(m, 2)<0)
+			printf("error en lock_varios. NO DEBE APARECER\n");
+		t0=tiempos_proceso(0);
+		while (tiempos_proceso(0)-t0 < 5)
+			;
+		if (unlock_varios(m, 2)<0)
+			printf("error en unlock_varios. NO DEBE APARECER\n");
+	}
+
+	printf("varios_hijo: termina\n");
+	return 0;
+}